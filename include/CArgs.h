@@ -1,12 +1,21 @@
 #ifndef CARGS_H
 #define CARGS_H
 
+#include <array>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
+#include <type_traits>
+#include <typeinfo>
+#include <functional>
+#include <cstddef>
 #include <cstring>
 #include <cstdlib>
 #include <cstdarg>
 #include <iostream>
+#include <limits>
 
 enum CArgType {
   CARG_TYPE_NONE,
@@ -14,7 +23,12 @@ enum CArgType {
   CARG_TYPE_INTEGER,
   CARG_TYPE_REAL,
   CARG_TYPE_STRING,
-  CARG_TYPE_CHOICE
+  CARG_TYPE_CHOICE,
+  CARG_TYPE_SIZE,
+  CARG_TYPE_DURATION,
+  CARG_TYPE_RATE,
+  CARG_TYPE_CUSTOM,
+  CARG_TYPE_PATH
 };
 
 enum CArgFlag {
@@ -25,17 +39,76 @@ enum CArgFlag {
   CARG_FLAG_MULTIPLE = (1<<3)
 };
 
+enum CArgPathCheck {
+  CARG_PATH_CHECK_NONE     = 0,
+  CARG_PATH_CHECK_EXISTS   = (1<<0),
+  CARG_PATH_CHECK_FILE     = (1<<1),
+  CARG_PATH_CHECK_DIR      = (1<<2),
+  CARG_PATH_CHECK_READABLE = (1<<3),
+  CARG_PATH_CHECK_WRITABLE = (1<<4)
+};
+
 //---
 
-class CArg {
+// 128 bit hash value
+struct CArgFingerprint {
+  uint64_t lo { 0 };
+  uint64_t hi { 0 };
+
+  bool operator==(const CArgFingerprint &rhs) const { return lo == rhs.lo && hi == rhs.hi; }
+  bool operator!=(const CArgFingerprint &rhs) const { return ! (*this == rhs); }
+
+  // 32 hex digits
+  std::string toString() const;
+};
+
+// 128 bit hash (two 64 bit lanes) of a sequence of values
+class CArgHasher {
  public:
-  CArg(const std::string &name, CArgType type, int flags, bool attached, const std::string &desc);
+  explicit CArgHasher(uint64_t seed=0) :
+   h1_(seed ^ 0x9e3779b97f4a7c15ULL), h2_(~seed ^ 0xc2b2ae3d27d4eb4fULL) {
+  }
+
+  void add(const void *data, std::size_t len);
+
+  template<typename T>
+  void add(const T &value) {
+    static_assert(std::is_arithmetic<T>::value, "arithmetic value expected");
+
+    add(&value, sizeof(T));
+  }
+
+  // length prefixed (so sequences of strings are unambiguous)
+  void addString(std::string_view str) {
+    add(uint64_t(str.size()));
+
+    add(str.data(), str.size());
+  }
+
+  CArgFingerprint result() const;
+
+ private:
+  uint64_t h1_  { 0 };
+  uint64_t h2_  { 0 };
+  uint64_t len_ { 0 };
+};
+
+//---
+
+// Option base class. The name, description and default (and choice) strings
+// are not copied: they must remain valid for the life of the option (CArgs
+// keeps them in its format string or in its string pool), so options are
+// only created by CArgs.
+class CArg {
+ protected:
+  CArg(std::string_view name, CArgType type, int flags, bool attached, std::string_view desc);
 
+ public:
   virtual ~CArg() { }
 
   bool optionCmp(const std::string &opt);
 
-  bool nameCmp(const std::string &name);
+  bool nameCmp(std::string_view name);
 
   virtual int getNumArgs() const;
 
@@ -51,10 +124,13 @@ class CArg {
 
   virtual bool setArg1(va_list *vargs) = 0;
 
-  std::string getName() const { return name_; }
+  std::string      getName    () const { return std::string(name_); }
+  std::string_view getNameView() const { return name_; }
 
   CArgType getType() const { return type_; }
 
+  int getFlags() const { return flags_; }
+
   bool getRequired() const { return flags_ & CARG_FLAG_REQUIRED; }
 
   bool getSkip() const { return flags_ & CARG_FLAG_SKIP; }
@@ -64,36 +140,56 @@ class CArg {
   bool getSet() const { return set_; }
   void setSet(bool set) { set_ = set; }
 
-  const std::string &getDesc() const { return desc_; }
+  std::string      getDesc    () const { return std::string(desc_); }
+  std::string_view getDescView() const { return desc_; }
+
+  const std::string &getError() const { return error_; }
+
+  // current value(s) as argument strings which parse back to the same value
+  virtual void getValueStrings(std::vector<std::string> &) const { }
+
+  // add normalized value to hash (so equal values have equal hashes)
+  virtual void hashValue(CArgHasher &) const { }
 
   virtual void print() const;
 
+ protected:
+  void setError(const std::string &error) { error_ = error; }
+
  private:
   std::string typeToString(CArgType type) const;
 
   std::string flagsToString(int flags) const;
 
  private:
-  std::string name_;
-  CArgType    type_     { CARG_TYPE_NONE };
-  int         flags_    { 0 };
-  bool        attached_ { false };
-  bool        set_      { false };
-  std::string desc_;
+  std::string_view name_;
+  CArgType         type_     { CARG_TYPE_NONE };
+  int              flags_    { 0 };
+  bool             attached_ { false };
+  bool             set_      { false };
+  std::string_view desc_;
+  std::string      error_;
 };
 
 //---
 
 class CArgBoolean : public CArg {
- public:
-  CArgBoolean(const std::string &name, int flags, bool defval, const std::string &desc);
+ protected:
+  friend class CArgs;
+
+  CArgBoolean(std::string_view name, int flags, bool defval, std::string_view desc);
 
+ public:
   int getNumArgs1() const override { return 0; }
 
   bool setValue1(const char **, int) override;
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   bool getValue() const { return value_; }
 
   void print() const override;
@@ -106,53 +202,89 @@ class CArgBoolean : public CArg {
 //---
 
 class CArgInteger : public CArg {
- public:
-  CArgInteger(const std::string &name, int flags, long defval, bool attached,
-              const std::string &desc);
+ protected:
+  friend class CArgs;
 
+  CArgInteger(std::string_view name, int flags, long defval, bool attached,
+              std::string_view desc);
+
+ public:
   int getNumArgs1() const override { return 1; }
 
   bool setValue1(const char **args, int) override;
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   long getValue() const { return value_; }
 
+  long getMin() const { return min_; }
+  long getMax() const { return max_; }
+
+  void setRange(long min, long max) { min_ = min; max_ = max; }
+
   void print() const override;
 
  private:
   long value_  { 0 };
   long defval_ { 0 };
+  long min_    { std::numeric_limits<long>::min() };
+  long max_    { std::numeric_limits<long>::max() };
 };
 
 //---
 
 class CArgReal : public CArg {
- public:
-  CArgReal(const std::string &name, int flags, double defval, bool attached,
-           const std::string &desc);
+ protected:
+  friend class CArgs;
+
+  CArgReal(std::string_view name, int flags, double defval, bool attached,
+           std::string_view desc);
 
+ public:
   int getNumArgs1() const override { return 1; }
 
   bool setValue1(const char **args, int) override;
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   double getValue() const { return value_; }
 
+  double getMin() const { return min_; }
+  double getMax() const { return max_; }
+
+  void setRange(double min, double max) { min_ = min; max_ = max; }
+
   void print() const override;
 
  private:
   double value_  { 0.0 };
   double defval_ { 0.0 };
+  double min_    { -std::numeric_limits<double>::max() };
+  double max_    { std::numeric_limits<double>::max() };
 };
 
 //---
 
+// compiled regular expression for string value validation
+class CArgPattern;
+
 class CArgString : public CArg {
+ protected:
+  friend class CArgs;
+
+  CArgString(std::string_view name, int flags, std::string_view defval,
+             bool attached, std::string_view desc);
+
  public:
-  CArgString(const std::string &name, int flags, const std::string &defval,
-             bool attached, const std::string &desc);
+ ~CArgString();
 
   int getNumArgs1() const override { return 1; }
 
@@ -160,13 +292,22 @@ class CArgString : public CArg {
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   const std::string &getValue() const { return value_; }
 
+  void setPattern(const std::string &pattern);
+
+  bool hasPattern() const { return bool(pattern_); }
+
   void print() const override;
 
  private:
-  std::string value_;
-  std::string defval_;
+  std::string                  value_;
+  std::string_view             defval_;
+  std::unique_ptr<CArgPattern> pattern_;
 };
 
 //---
@@ -175,57 +316,614 @@ class CArgStringList : public CArg {
  public:
   typedef std::vector<std::string> ValueList;
 
+ protected:
+  friend class CArgs;
+
+  CArgStringList(std::string_view name, int flags, std::string_view defval,
+                 bool attached, std::string_view desc);
+
  public:
-  CArgStringList(const std::string &name, int flags, const std::string &defval,
-                 bool attached, const std::string &desc);
+ ~CArgStringList();
 
-  int getNumArgs1() const override { return int(values_.size()); }
+  int getNumArgs1() const override { return 1; }
 
   bool setValue1(const char **args, int) override;
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   const ValueList &getValue() const { return values_; }
 
+  void setPattern(const std::string &pattern);
+
   void print() const override;
 
  private:
-  ValueList   values_;
-  std::string defval_;
+  ValueList                    values_;
+  std::string_view             defval_;
+  std::unique_ptr<CArgPattern> pattern_;
 };
 
 //---
 
 class CArgChoice : public CArg {
  public:
-  typedef std::vector<std::string> ChoiceList;
+  typedef std::vector<std::string_view>             ChoiceList;
+  typedef std::vector<long>                         ValueList;
+  typedef std::unordered_map<std::string_view,long> ChoiceMap;
+
+ protected:
+  friend class CArgs;
+
+  // choices are '<name>' or '<name>=<value>'
+  CArgChoice(std::string_view name, int flags, const ChoiceList &choices,
+             long defval, bool attached, std::string_view desc);
+
+  // choice names and values
+  CArgChoice(std::string_view name, int flags, const ChoiceList &choices,
+             const ValueList &values, long defval, bool attached, std::string_view desc);
+
+ public:
+  int getNumArgs1() const override { return 1; }
+
+  bool setValue1(const char **args, int) override;
+
+  bool setArg1(va_list *vargs) override;
+
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
+  long getValue() const { return value_; }
+
+  const ChoiceList &getChoices() const { return choices_; }
+  const ValueList  &getValues () const { return values_; }
+
+  bool lookupChoice(const std::string &choice, long &value) const;
+
+  void print() const override;
+
+ protected:
+  void setChoiceValue(long value) { value_ = value; }
+
+ private:
+  void addChoices(const ChoiceList &names, const ValueList &values);
+
+ private:
+  long        value_ { 0 };
+  ChoiceList  choices_;
+  ValueList   values_;
+  ChoiceMap   choiceMap_;
+  std::string foldedNames_; // storage for case folded choice map keys
+  long        defval_ { 0 };
+};
+
+//---
+
+// Size in bytes (e.g. 4GiB, 1.5MB, 512)
+class CArgSize : public CArg {
+ protected:
+  friend class CArgs;
+
+  CArgSize(std::string_view name, int flags, long defval, bool attached,
+           std::string_view desc);
 
  public:
-  CArgChoice(const std::string &name, int flags, const ChoiceList &choices,
-             long defval, bool attached, const std::string &desc);
+  int getNumArgs1() const override { return 1; }
+
+  bool setValue1(const char **args, int) override;
+
+  bool setArg1(va_list *vargs) override;
+
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
+  long getValue() const { return value_; }
+
+  void print() const override;
+
+  static bool parseValue(const char *str, long &value);
 
+ private:
+  long value_  { 0 };
+  long defval_ { 0 };
+};
+
+//---
+
+// Duration in nanoseconds (e.g. 250ms, 1.5h, 30 (seconds))
+class CArgDuration : public CArg {
+ protected:
+  friend class CArgs;
+
+  CArgDuration(std::string_view name, int flags, long defval, bool attached,
+               std::string_view desc);
+
+ public:
   int getNumArgs1() const override { return 1; }
 
   bool setValue1(const char **args, int) override;
 
   bool setArg1(va_list *vargs) override;
 
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
   long getValue() const { return value_; }
 
   void print() const override;
 
+  static bool parseValue(const char *str, long &value);
+
+ private:
+  long value_  { 0 };
+  long defval_ { 0 };
+};
+
+//---
+
+// Rate as count per period in nanoseconds (e.g. 10k/s, 500/ms, 20 (per second)).
+// A fractional count is kept exact by scaling the period (0.5/s is 1 per 2s).
+class CArgRate : public CArg {
+ protected:
+  friend class CArgs;
+
+  CArgRate(std::string_view name, int flags, long defcount, long defperiod,
+           bool attached, std::string_view desc);
+
+ public:
+  int getNumArgs1() const override { return 1; }
+
+  bool setValue1(const char **args, int) override;
+
+  bool setArg1(va_list *vargs) override;
+
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
+  long getCount () const { return count_; }
+  long getPeriod() const { return period_; }
+
+  // count per second
+  double getValue() const { return 1E9*double(count_)/double(period_); }
+
+  void print() const override;
+
+  static bool parseValue(const char *str, long &count, long &period);
+
+ private:
+  long count_     { 0 };
+  long period_    { 1000000000L };
+  long defcount_  { 0 };
+  long defperiod_ { 1000000000L };
+};
+
+//---
+
+// File path(s) checked (in one parallel batch) after all options are parsed
+class CArgPath : public CArg {
+ public:
+  typedef std::vector<std::string> ValueList;
+
+ protected:
+  friend class CArgs;
+
+  CArgPath(std::string_view name, int flags, int checks, std::string_view defval,
+           bool attached, std::string_view desc);
+
+ public:
+  int getNumArgs1() const override { return 1; }
+
+  bool setValue1(const char **args, int) override;
+
+  bool setArg1(va_list *vargs) override;
+
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
+  // last value (or default)
+  std::string_view getValue() const;
+
+  const ValueList &getValues() const { return values_; }
+
+  int getChecks() const { return checks_; }
+  void setChecks(int checks) { checks_ = checks; }
+
+  void print() const override;
+
+ private:
+  ValueList        values_;
+  std::string_view defval_;
+  int              checks_ { CARG_PATH_CHECK_NONE };
+};
+
+//---
+
+// Maximum size of custom type value (stored inline in option)
+#define CARG_CUSTOM_SIZE 64
+
+// Custom option type registered with CArgs::registerType. The type letter
+// (lower case unattached, upper case attached) is used in the format string.
+struct CArgCustomType {
+  typedef std::function<bool (const char *str, void *data)> ParseProc;
+  typedef std::function<std::string (const void *data)>    FormatProc;
+  typedef std::array<unsigned char, CARG_CUSTOM_SIZE>       Data;
+
+  std::string           name;
+  char                  letter   { '\0' };
+  std::size_t           size     { 0 };
+  const std::type_info *typeInfo { nullptr };
+  ParseProc             parse;
+  FormatProc            format;
+  Data                  defdata  { };
+};
+
+typedef std::shared_ptr<const CArgCustomType> CArgCustomTypeP;
+
+class CArgCustom : public CArg {
+ protected:
+  friend class CArgs;
+
+  CArgCustom(std::string_view name, int flags, const CArgCustomTypeP &customType,
+             std::string_view defval, bool attached, std::string_view desc);
+
+ public:
+  int getNumArgs1() const override { return 1; }
+
+  bool setValue1(const char **args, int) override;
+
+  bool setArg1(va_list *vargs) override;
+
+  void getValueStrings(std::vector<std::string> &values) const override;
+
+  void hashValue(CArgHasher &hasher) const override;
+
+  const CArgCustomType &getCustomType() const { return *customType_; }
+
+  const void *getData() const { return data_; }
+
+  void print() const override;
+
  private:
-  long       value_ { 0 };
-  ChoiceList choices_;
-  long       defval_ { 0 };
+  CArgCustomTypeP customType_;
+  alignas(std::max_align_t) unsigned char data_[CARG_CUSTOM_SIZE];
+};
+
+//---
+
+// Enum class bound to a choice option. The choice names are the enumerator
+// names, taken at compile time from the enum definition, e.g.
+//
+//   CARG_ENUM(Codec, h264, vp9, av1)
+//
+// defines 'enum class Codec { h264, vp9, av1 };' and its name list. An existing
+// enum with default (sequential) enumerator values can be bound by defining
+// 'constexpr const char *cargEnumNames(Codec) { return "h264, vp9, av1"; }'
+// in the enum's namespace.
+#define CARG_ENUM(NAME, ...) \
+  enum class NAME { __VA_ARGS__ }; \
+  constexpr const char *cargEnumNames(NAME) { return #__VA_ARGS__; }
+
+namespace CArgEnumUtil {
+  constexpr char foldChar(char c) {
+    return (c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c);
+  }
+
+  constexpr bool isNameChar(char c) {
+    return ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '_');
+  }
+
+  // case folded FNV-1a with seed and final mix
+  constexpr uint64_t hash(const char *str, std::size_t len, uint64_t seed) {
+    uint64_t h = 0xcbf29ce484222325ULL ^ (seed*0x9e3779b97f4a7c15ULL);
+
+    for (std::size_t i = 0; i < len; ++i) {
+      h ^= uint8_t(foldChar(str[i]));
+      h *= 0x100000001b3ULL;
+    }
+
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL; h ^= h >> 33;
+
+    return h;
+  }
+
+  constexpr std::size_t countNames(const char *str) {
+    std::size_t n = 0;
+
+    for (std::size_t i = 0; str[i]; ) {
+      if (isNameChar(str[i])) {
+        ++n;
+
+        while (str[i] && str[i] != ',')
+          ++i;
+      }
+      else
+        ++i;
+    }
+
+    return n;
+  }
+
+  constexpr std::size_t tableSize(std::size_t n) {
+    std::size_t size = 1;
+
+    while (size < n)
+      size <<= 1;
+
+    return size;
+  }
+}
+
+// Compile time name table and perfect hash (hash and displace) for an enum
+template<typename E>
+class CArgEnumTable {
+ public:
+  struct Entry {
+    std::size_t pos { 0 };
+    std::size_t len { 0 };
+  };
+
+  static constexpr const char  *str      = cargEnumNames(E());
+  static constexpr std::size_t  numNames = CArgEnumUtil::countNames(str);
+  static constexpr std::size_t  numSlots = CArgEnumUtil::tableSize(numNames);
+
+  typedef std::array<Entry   , numNames> Entries;
+  typedef std::array<int     , numSlots> Slots;
+  typedef std::array<uint32_t, numSlots> Displacements;
+
+  struct Table {
+    Displacements disp  { };
+    Slots         slots { };
+  };
+
+ public:
+  static constexpr Entries makeEntries() {
+    Entries entries { };
+
+    std::size_t n = 0;
+
+    for (std::size_t i = 0; str[i]; ) {
+      if (CArgEnumUtil::isNameChar(str[i])) {
+        entries[n].pos = i;
+
+        while (CArgEnumUtil::isNameChar(str[i]))
+          ++i;
+
+        entries[n].len = i - entries[n].pos;
+
+        ++n;
+
+        while (str[i] && str[i] != ',')
+          ++i;
+      }
+      else
+        ++i;
+    }
+
+    return entries;
+  }
+
+  static constexpr Entries entries = makeEntries();
+
+  static constexpr std::size_t slotHash(std::size_t i, uint32_t seed) {
+    return std::size_t(CArgEnumUtil::hash(&str[entries[i].pos], entries[i].len, seed) &
+                       (numSlots - 1));
+  }
+
+  static constexpr Table makeTable() {
+    Table table { };
+
+    for (std::size_t s = 0; s < numSlots; ++s)
+      table.slots[s] = -1;
+
+    // assign names to buckets
+    std::array<std::size_t, numSlots> bucketSize { };
+    std::array<std::size_t, numNames> bucket     { };
+
+    for (std::size_t i = 0; i < numNames; ++i) {
+      bucket[i] = slotHash(i, 0);
+
+      ++bucketSize[bucket[i]];
+    }
+
+    // place largest buckets first, finding a displacement (seed) which moves
+    // all names in the bucket to free slots
+    std::array<bool, numSlots> done { };
+
+    for (std::size_t n = 0; n < numSlots; ++n) {
+      std::size_t b = numSlots;
+
+      for (std::size_t k = 0; k < numSlots; ++k)
+        if (! done[k] && (b == numSlots || bucketSize[k] > bucketSize[b]))
+          b = k;
+
+      done[b] = true;
+
+      if (bucketSize[b] == 0)
+        break;
+
+      for (uint32_t d = 1; ; ++d) {
+        if (d > 1000000)
+          throw "CArgEnumTable: duplicate (case folded) enum names";
+
+        bool ok = true;
+
+        for (std::size_t i = 0; ok && i < numNames; ++i) {
+          if (bucket[i] != b)
+            continue;
+
+          std::size_t s = slotHash(i, d);
+
+          if (table.slots[s] != -1)
+            ok = false;
+          else
+            table.slots[s] = int(i);
+        }
+
+        if (ok) {
+          table.disp[b] = d;
+          break;
+        }
+
+        // undo partial placement
+        for (std::size_t s = 0; s < numSlots; ++s)
+          if (table.slots[s] != -1 && bucket[std::size_t(table.slots[s])] == b)
+            table.slots[s] = -1;
+      }
+    }
+
+    return table;
+  }
+
+  static constexpr Table table = makeTable();
+
+ public:
+  static std::size_t numValues() { return numNames; }
+
+  static std::string name(std::size_t i) {
+    return std::string(&str[entries[i].pos], entries[i].len);
+  }
+
+  static bool lookup(const char *name, bool no_case, E &value) {
+    std::size_t len = strlen(name);
+
+    uint32_t d = table.disp[CArgEnumUtil::hash(name, len, 0) & (numSlots - 1)];
+
+    if (d == 0)
+      return false;
+
+    int ind = table.slots[CArgEnumUtil::hash(name, len, d) & (numSlots - 1)];
+
+    if (ind < 0)
+      return false;
+
+    const Entry &entry = entries[std::size_t(ind)];
+
+    if (entry.len != len)
+      return false;
+
+    for (std::size_t i = 0; i < len; ++i) {
+      char c1 = str[entry.pos + i], c2 = name[i];
+
+      if (no_case) {
+        c1 = CArgEnumUtil::foldChar(c1);
+        c2 = CArgEnumUtil::foldChar(c2);
+      }
+
+      if (c1 != c2)
+        return false;
+    }
+
+    value = E(ind);
+
+    return true;
+  }
+
+  // choice names (views of the static name string) and values
+  static CArgChoice::ChoiceList choices() {
+    CArgChoice::ChoiceList choices;
+
+    for (std::size_t i = 0; i < numNames; ++i)
+      choices.push_back(std::string_view(&str[entries[i].pos], entries[i].len));
+
+    return choices;
+  }
+
+  static CArgChoice::ValueList values() {
+    CArgChoice::ValueList values;
+
+    for (std::size_t i = 0; i < numNames; ++i)
+      values.push_back(long(i));
+
+    return values;
+  }
+};
+
+//---
+
+template<typename E>
+class CArgEnum : public CArgChoice {
+ public:
+  typedef CArgEnumTable<E> Table;
+
+ protected:
+  friend class CArgs;
+
+  CArgEnum(std::string_view name, int flags, E defval, bool attached,
+           std::string_view desc) :
+   CArgChoice(name, flags, Table::choices(), Table::values(), long(defval), attached, desc) {
+  }
+
+ public:
+  bool setValue1(const char **args, int) override {
+    E value;
+
+    if (! Table::lookup(args[0], getFlags() & CARG_FLAG_NO_CASE, value))
+      return false;
+
+    setChoiceValue(long(value));
+
+    return true;
+  }
+
+  E getEnumValue() const { return E(getValue()); }
 };
 
 //---
 
+class CArgsTokenizer;
+
+// Block allocated storage for option strings which are not views of the
+// format string (unescaped text and strings added by the API). Added strings
+// never move so views of them stay valid until the pool is cleared.
+class CArgStringPool {
+ public:
+  CArgStringPool() { }
+
+  CArgStringPool(const CArgStringPool &) = delete;
+  CArgStringPool &operator=(const CArgStringPool &) = delete;
+
+  std::string_view add(const std::string_view &str);
+
+  void clear();
+
+  std::size_t memUsage() const { return memUsage_; }
+
+ private:
+  static const std::size_t BLOCK_SIZE = 4096;
+
+  typedef std::vector<std::unique_ptr<char []>> Blocks;
+
+  Blocks      blocks_;
+  std::size_t pos_      { BLOCK_SIZE }; // position in last block
+  std::size_t memUsage_ { 0 };
+};
+
+
+// Note: the getXArg methods look up options by name in the (mutable) option
+// list and are not guaranteed to be thread safe. Use a CArgsView of the
+// parsed CArgs to read option values from multiple threads.
 class CArgs {
  public:
-  typedef std::vector<CArg *>      ArgList;
-  typedef std::vector<std::string> StringList;
+  typedef std::vector<CArg *>             ArgList;
+  typedef std::vector<std::string>        StringList;
+  typedef std::vector<CArgCustomTypeP>    TypeList;
+  typedef std::unique_ptr<CArgsTokenizer> TokenizerP;
+
+  typedef std::function<void (const CArg &arg)>          ActionProc;
+  typedef std::function<void (bool value)>               BooleanAction;
+  typedef std::function<void (long value)>               IntegerAction;
+  typedef std::function<void (double value)>             RealAction;
+  typedef std::function<void (const std::string &value)> StringAction;
+  typedef std::vector<ActionProc>                        ActionList;
 
  public:
   CArgs(const std::string &def="");
@@ -233,8 +931,22 @@ class CArgs {
 
   void setFormat(const std::string &def);
 
+  const std::string &getFormat() const { return def_; }
+
   bool isHelp() const { return help_; }
 
+  // expand @<file> arguments to the (shell quoted) arguments in the file
+  bool isResponseFiles() const { return responseFiles_; }
+  void setResponseFiles(bool b) { responseFiles_ = b; }
+
+  // expand glob patterns in positional arguments (see CArgsGlob)
+  bool isGlobPositionals() const { return globPositionals_; }
+  void setGlobPositionals(bool b) { globPositionals_ = b; }
+
+  // fail parse if a required option is not set (default true)
+  bool isRequiredChecked() const { return requiredChecked_; }
+  void setRequiredChecked(bool b) { requiredChecked_ = b; }
+
   //---
 
   bool vparse(int  argc, char **argv, ...);
@@ -245,6 +957,9 @@ class CArgs {
   bool parse(const std::vector<std::string> &args);
   bool parse(std::vector<std::string> &args);
 
+  // parse command string (e.g. "-f -i 5 -s 'two words'")
+  bool parseString(const std::string &str);
+
   //---
 
   bool isBooleanArg   (const std::string &name) const;
@@ -253,6 +968,10 @@ class CArgs {
   bool isStringArg    (const std::string &name) const;
   bool isStringListArg(const std::string &name) const;
   bool isChoiceArg    (const std::string &name) const;
+  bool isSizeArg      (const std::string &name) const;
+  bool isDurationArg  (const std::string &name) const;
+  bool isRateArg      (const std::string &name) const;
+  bool isPathArg      (const std::string &name) const;
 
   bool isBooleanArg   (int i) const;
   bool isIntegerArg   (int i) const;
@@ -275,6 +994,11 @@ class CArgs {
   std::string getStringArg    (const std::string &name) const;
   StringList  getStringListArg(const std::string &name) const;
   long        getChoiceArg    (const std::string &name) const;
+  long        getSizeArg      (const std::string &name) const;
+  long        getDurationArg  (const std::string &name) const;
+  double      getRateArg      (const std::string &name) const;
+  std::string getPathArg      (const std::string &name) const;
+  StringList  getPathListArg  (const std::string &name) const;
 
   bool        getBooleanArg   (int i) const;
   long        getIntegerArg   (int i) const;
@@ -282,6 +1006,9 @@ class CArgs {
   std::string getStringArg    (int i) const;
   StringList  getStringListArg(int i) const;
   long        getChoiceArg    (int i) const;
+  long        getSizeArg      (int i) const;
+  long        getDurationArg  (int i) const;
+  double      getRateArg      (int i) const;
 
   template<typename T> T getArg(const std::string &name) const {
     T dummy { };
@@ -289,7 +1016,80 @@ class CArgs {
     return getArgHelper(name, dummy);
   }
 
+  //---
+
+  // register custom type which is parsed from the argument string by 'parse'
+  // and stored inline in the option. Types must be registered before the
+  // format is set. The optional 'format' converts a value back to an argument
+  // string (needed to regenerate a command line).
+  template<typename T>
+  void registerType(char letter, const std::string &name,
+                    bool (*parse)(const char *str, T &value),
+                    std::string (*format)(const T &value)=nullptr) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "custom type must be trivially copyable");
+    static_assert(sizeof(T) <= CARG_CUSTOM_SIZE && alignof(T) <= alignof(std::max_align_t),
+                  "custom type too large for inline storage");
+
+    auto type = std::make_shared<CArgCustomType>();
+
+    type->name     = name;
+    type->letter   = letter;
+    type->size     = sizeof(T);
+    type->typeInfo = &typeid(T);
+    type->parse    = [parse](const char *str, void *data) {
+      return parse(str, *static_cast<T *>(data)); };
+
+    if (format)
+      type->format = [format](const void *data) {
+        return format(*static_cast<const T *>(data)); };
+
+    T defval { };
+
+    memcpy(type->defdata.data(), &defval, sizeof(T));
+
+    addType(type);
+  }
+
+  void addCustomArg(const std::string &name, const std::string &typeName, int flags,
+                    const std::string &defval, bool attached, const std::string &desc);
+
+  bool isCustomArg(const std::string &name) const;
+
+  template<typename T> T getCustomArg(const std::string &name) const {
+    const CArgCustom *arg = lookupCustomArg(name, typeid(T));
+
+    T value;
+
+    memcpy(&value, arg->getData(), sizeof(T));
+
+    return value;
+  }
+
+  template<typename T> T getCustomArg(int i) const {
+    const CArgCustom *arg = lookupCustomArg(i, typeid(T));
+
+    T value;
+
+    memcpy(&value, arg->getData(), sizeof(T));
+
+    return value;
+  }
+
+  //---
+
+  template<typename E>
+  void addEnumArg(const std::string &name, int flags, E defval, bool attached,
+                  const std::string &desc) {
+    args_.push_back(new CArgEnum<E>(intern(name), flags, defval, attached, intern(desc)));
+  }
+
  private:
+  template<typename E>
+  typename std::enable_if<std::is_enum<E>::value, E>::type
+  getArgHelper(const std::string &name, const E &) const {
+    return E(getChoiceArg(name)); }
+
   bool        getArgHelper(const std::string &name, const bool &) const {
     return getBooleanArg   (name); }
   long        getArgHelper(const std::string &name, const long &) const {
@@ -304,12 +1104,64 @@ class CArgs {
   //---
 
  public:
+  void setIntegerRange (const std::string &name, long min, long max);
+  void setRealRange    (const std::string &name, double min, double max);
+  void setStringPattern(const std::string &name, const std::string &pattern);
+  void setPathChecks   (const std::string &name, int checks);
+
+  //---
+
+  // action called during parse (in command line order) each time the option's
+  // value is set. The typed actions are passed the converted value (the last
+  // value for string list and path options).
+  void setAction(const std::string &name, const ActionProc &proc);
+
+  void setBooleanAction (const std::string &name, const BooleanAction &proc);
+  void setIntegerAction (const std::string &name, const IntegerAction &proc);
+  void setRealAction    (const std::string &name, const RealAction &proc);
+  void setStringAction  (const std::string &name, const StringAction &proc);
+  void setChoiceAction  (const std::string &name, const IntegerAction &proc);
+  void setSizeAction    (const std::string &name, const IntegerAction &proc);
+  void setDurationAction(const std::string &name, const IntegerAction &proc);
+  void setRateAction    (const std::string &name, const RealAction &proc);
+  void setPathAction    (const std::string &name, const StringAction &proc);
+
+  template<typename T>
+  void setCustomAction(const std::string &name, const std::function<void (const T &)> &proc) {
+    (void) lookupCustomArg(name, typeid(T));
+
+    setAction(name, [proc](const CArg &arg) {
+      T value;
+
+      memcpy(&value, static_cast<const CArgCustom &>(arg).getData(), sizeof(T));
+
+      proc(value);
+    });
+  }
+
+  template<typename E>
+  void setEnumAction(const std::string &name, const std::function<void (E)> &proc) {
+    setChoiceAction(name, [proc](long value) { proc(E(value)); });
+  }
+
+  //---
+
+  const StringList &getErrors() const { return errors_; }
+
+  // non-option arguments of last parse (glob expanded if enabled)
+  const StringList &getPositionals() const { return positionals_; }
+
+  //---
+
   void resetSet();
   bool checkRequired();
 
   int   getNumArgs() const { return int(args_.size()); }
   CArg *getArg(int i) const { return args_[size_t(i)]; }
 
+  // index of named option (-1 if not found)
+  int getArgIndex(const std::string &name) const;
+
   bool checkOption(const char *arg, std::string &opt);
 
   void unhandledOpt(const std::string &opt);
@@ -318,6 +1170,17 @@ class CArgs {
 
   void print() const;
 
+  // 128 bit fingerprint of the option values and set flags (independent of the
+  // order and spelling of the arguments). Updated incrementally as values are
+  // set by parse (values set directly with CArg::setValue are not included).
+  CArgFingerprint getFingerprint() const;
+
+  // fingerprint of option id, set flag and current value
+  CArgFingerprint getArgFingerprint(int id) const;
+
+  // print approximate memory used by each option
+  void printMemory(std::ostream &os=std::cout) const;
+
  private:
   CArgBoolean    *lookupBooleanArg   (const std::string &name) const;
   CArgInteger    *lookupIntegerArg   (const std::string &name) const;
@@ -325,17 +1188,89 @@ class CArgs {
   CArgString     *lookupStringArg    (const std::string &name) const;
   CArgStringList *lookupStringListArg(const std::string &name) const;
   CArgChoice     *lookupChoiceArg    (const std::string &name) const;
+  CArgSize       *lookupSizeArg      (const std::string &name) const;
+  CArgDuration   *lookupDurationArg  (const std::string &name) const;
+  CArgRate       *lookupRateArg      (const std::string &name) const;
+  CArgPath       *lookupPathArg      (const std::string &name) const;
 
   bool parse1(int *argc, char **argv, bool update);
   bool parse1(std::vector<std::string> &args, bool update);
 
+  bool parseArgv(int *argc, char **argv, bool update);
+  bool parseArgs(std::vector<std::string> &args, bool update);
+
+  bool hasResponseFile(int argc, char **argv) const;
+
+  void expandResponseFiles(StringList &args, int depth=0);
+
   CArg *lookupArg(const std::string &name) const;
 
+  const CArgCustom *lookupCustomArg(const std::string &name, const std::type_info &ti) const;
+  const CArgCustom *lookupCustomArg(int i, const std::type_info &ti) const;
+
+  void addType(const CArgCustomTypeP &type);
+
+  CArgCustomTypeP lookupType(char letter) const;
+  CArgCustomTypeP lookupType(const std::string &name) const;
+
+  void expandPositionals();
+
+  void checkPaths();
+
+  // string which is valid for life of options (view of format string or pool copy)
+  std::string_view intern(const std::string_view &str);
+
+  // string in format string (unescaped into pool if it contains '\\')
+  std::string_view formatString(std::size_t pos, std::size_t len);
+
+  void updateMatchIndex();
+
+  int matchOption(const char *opt, size_t len) const;
+
+  // add fingerprints of options added since last parse
+  void updateFingerprints();
+
+  // update fingerprint after value of option changed
+  void updateFingerprint(size_t id);
+
+  void doAction(size_t id) {
+    if (id < actions_.size() && actions_[id])
+      actions_[id](*args_[id]);
+  }
+
+  void addError(const std::string &msg);
+
+  bool reportErrors() const;
+
  private:
-  std::string def_;
-  ArgList     args_;
-  bool        skip_remaining_ { false };
-  bool        help_ { false };
+  std::string    def_;
+  CArgStringPool pool_;
+  ArgList        args_;
+  StringList     errors_;
+  TypeList       types_;
+  StringList     positionals_;
+  StringList     responseArgs_;
+  TokenizerP     tokenizer_;
+  ActionList     actions_;
+  bool           globPositionals_ { false };
+  bool           responseFiles_ { false };
+  bool           requiredChecked_ { true };
+  bool           skip_remaining_ { false };
+  bool           help_ { false };
+
+  // option name match index used by parse (structure of arrays of the
+  // fields compared for each option, rebuilt when options are added)
+  enum {
+    MATCH_ATTACHED = (1<<0),
+    MATCH_NO_CASE  = (1<<1)
+  };
+
+  std::vector<uint32_t> matchHashes_; // folded name hash
+  std::vector<uint32_t> matchInfo_;   // name length << 2 | MATCH_ flags
+
+  // fingerprint (sum of per option fingerprints so independent of order)
+  CArgFingerprint              fingerprint_;
+  std::vector<CArgFingerprint> argFingerprints_;
 };
 
 #endif
@@ -0,0 +1,100 @@
+#ifndef CARGS_CACHE_H
+#define CARGS_CACHE_H
+
+#include <CArgsView.h>
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Cache of parse results for a fixed option format, for servers which parse
+// the same argument lists many times.
+//
+// Results are immutable CArgsViews shared by all callers. The key is a 64 bit
+// hash of the argument tokens (argv[0] is not part of the key) and a hit is
+// only returned if the stored tokens are equal. Entries are split into
+// shards (by hash) each with its own mutex and least recently used list so
+// concurrent lookups of different arguments rarely contend, and the lock is
+// only held for the lookup (misses are parsed, into a new CArgs, unlocked).
+// Failed parses are not cached.
+//
+// The key is only the argument text, so a result which also depends on the
+// file system (path checks, glob expansion of positionals or response
+// files) could become stale. If the format (after the init proc) uses any
+// of these every parse is done without the cache (isCacheable is false).
+class CArgsCache {
+ public:
+  typedef std::shared_ptr<const CArgsView> ViewP;
+  typedef std::function<void (CArgs &)>    InitProc;
+
+ public:
+  // capacity is total number of results (split evenly over shards)
+  CArgsCache(const std::string &def, size_t capacity=1024, uint numShards=16);
+ ~CArgsCache();
+
+  CArgsCache(const CArgsCache &) = delete;
+  CArgsCache &operator=(const CArgsCache &) = delete;
+
+  // called for each new CArgs before format is set (e.g. to register types)
+  void setInitProc(const InitProc &proc) { initProc_ = proc; updateCacheable(); }
+
+  // results only depend on argument text (so can be cached)
+  bool isCacheable() const { return cacheable_; }
+
+  // parse arguments (argv[0] is program name). Null if parse fails.
+  ViewP parse(int argc, const char * const *argv);
+  ViewP parse(const std::vector<std::string> &args);
+
+  // parse command string (split into words by CArgsTokenizer)
+  ViewP parseString(const std::string &str);
+
+  size_t capacity() const { return shardCapacity_*shards_.size(); }
+
+  size_t size() const;
+
+  uint64_t hits  () const;
+  uint64_t misses() const;
+
+  // fraction of lookups which were hits
+  double hitRate() const;
+
+  void resetCounters();
+
+  void clear();
+
+ private:
+  struct Entry {
+    uint64_t                 hash { 0 };
+    std::vector<std::string> tokens;
+    ViewP                    view;
+  };
+
+  typedef std::list<Entry>                                       EntryList;
+  typedef std::unordered_multimap<uint64_t, EntryList::iterator> EntryMap;
+
+  // separate cache lines so shards do not contend
+  struct alignas(64) Shard {
+    mutable std::mutex    mutex;
+    EntryList             entries; // most recently used first
+    EntryMap              map;
+    std::atomic<uint64_t> hits   { 0 };
+    std::atomic<uint64_t> misses { 0 };
+  };
+
+  void updateCacheable();
+
+  ViewP parse1(const char *arg0, size_t num, const std::string_view *tokens);
+
+  ViewP parseTokens(const char *arg0, size_t num, const std::string_view *tokens) const;
+
+ private:
+  std::string                         def_;
+  InitProc                            initProc_;
+  bool                                cacheable_ { true };
+  size_t                              shardCapacity_ { 0 };
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+#endif
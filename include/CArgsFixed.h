@@ -0,0 +1,632 @@
+#ifndef CARGS_FIXED_H
+#define CARGS_FIXED_H
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+// Fixed capacity options parser for code which must not allocate after
+// initialization (e.g. real time controllers).
+//
+// All storage is inline (MaxOpts options, MaxPos positionals and MaxBytes of
+// string data) so a CArgsFixed can be a static or stack object. Nothing is
+// allocated and no exceptions are thrown: a capacity overflow, bad format or
+// bad argument sets an error code (getError) and the call returns false.
+//
+// The format is the same as CArgs for a subset of types and flags:
+//
+//   -<name>:<type>[choices]{min,max}<flags>=<default> (<description>)
+//
+// with types f, i/I, r/R, s/S and c/C, a range for i/r (either bound can be
+// omitted) and flags n (no case names and choices), r (required) and s
+// (ignored). Names and choices are views of the
+// format string so it must remain valid (e.g. a string literal). String
+// values are copied (so do not reference argv after parse).
+//
+// Parse is as CArgs::parse except that an unrecognised option is an error.
+template<size_t MaxOpts, size_t MaxPos=16, size_t MaxBytes=1024>
+class CArgsFixed {
+ public:
+  enum Error {
+    ERROR_NONE,
+    ERROR_FORMAT,
+    ERROR_TOO_MANY_OPTIONS,
+    ERROR_TOO_MANY_POSITIONALS,
+    ERROR_TOO_MANY_BYTES,
+    ERROR_UNKNOWN_OPTION,
+    ERROR_MISSING_VALUE,
+    ERROR_INVALID_VALUE,
+    ERROR_REQUIRED
+  };
+
+ public:
+  CArgsFixed() { }
+
+  explicit CArgsFixed(const char *format) { setFormat(format); }
+
+  // define options (replaces existing options)
+  bool setFormat(const char *format);
+
+  // parse arguments (argv[0] is program name)
+  bool parse(int argc, const char * const *argv);
+
+  //---
+
+  Error getError() const { return error_; }
+
+  // argv index or option id of error (-1 if none)
+  int getErrorIndex () const { return errorIndex_; }
+  int getErrorOption() const { return errorOption_; }
+
+  static const char *errorMessage(Error error);
+
+  //---
+
+  int getNumArgs() const { return int(numOpts_); }
+
+  // option id for name (-1 if not found)
+  int getArgIndex(std::string_view name) const {
+    for (size_t i = 0; i < numOpts_; ++i)
+      if (opts_[i].name == name)
+        return int(i);
+
+    return -1;
+  }
+
+  std::string_view getName(int id) const { return (validId(id) ? opts_[id].name : ""); }
+
+  bool isSet(int id) const { return validId(id) && opts_[id].set; }
+
+  // values (0 or "" for invalid id or wrong type)
+  bool        getBoolean(int id) const { return checkType(id, 'f') && opts_[id].value.i != 0; }
+  long        getInteger(int id) const { return (checkType(id, 'i') ? opts_[id].value.i : 0); }
+  double      getReal   (int id) const { return (checkType(id, 'r') ? opts_[id].value.r : 0.0); }
+  long        getChoice (int id) const { return (checkType(id, 'c') ? opts_[id].value.i : 0); }
+  const char *getString (int id) const {
+    return (checkType(id, 's') && opts_[id].value.i >= 0 ? &bytes_[opts_[id].value.i] : "");
+  }
+
+  //---
+
+  int getNumPositionals() const { return int(numPos_); }
+
+  const char *getPositional(int i) const {
+    return (i >= 0 && size_t(i) < numPos_ ? &bytes_[positionals_[i]] : "");
+  }
+
+ private:
+  // integer/boolean/choice value or string offset (-1 if none) in i
+  struct Value {
+    long   i { 0 };
+    double r { 0.0 };
+  };
+
+  struct Opt {
+    std::string_view name;
+    std::string_view choices;
+    char             type     { 'f' };
+    bool             attached { false };
+    bool             required { false };
+    bool             noCase   { false };
+    bool             hasRange { false };
+    bool             set      { false };
+    double           min      { 0.0 };
+    double           max      { 0.0 };
+    Value            defval;
+    Value            value;
+  };
+
+  bool validId(int id) const { return id >= 0 && size_t(id) < numOpts_; }
+
+  bool checkType(int id, char type) const { return validId(id) && opts_[id].type == type; }
+
+  bool fail(Error error, int index=-1, int option=-1) {
+    error_       = error;
+    errorIndex_  = index;
+    errorOption_ = option;
+
+    return false;
+  }
+
+  // copy string to bytes (with '\' escapes removed if unescape), -1 if no space
+  long addString(const char *str, size_t len, bool unescape=false) {
+    if (bytesUsed_ + len + 1 > MaxBytes)
+      return -1;
+
+    long pos = long(bytesUsed_);
+
+    for (size_t i = 0; i < len; ++i) {
+      if (unescape && str[i] == '\\' && i + 1 < len)
+        ++i;
+
+      bytes_[bytesUsed_++] = str[i];
+    }
+
+    bytes_[bytesUsed_++] = '\0';
+
+    return pos;
+  }
+
+  // compare first len chars of argument to option name
+  static bool matchName(const Opt &opt, const char *arg, size_t len) {
+    if (! opt.noCase)
+      return (memcmp(arg, opt.name.data(), len) == 0);
+
+    for (size_t i = 0; i < len; ++i)
+      if (tolower(static_cast<unsigned char>(arg[i])) !=
+          tolower(static_cast<unsigned char>(opt.name[i])))
+        return false;
+
+    return true;
+  }
+
+  bool setValue(Opt &opt, const char *str, Value &value);
+
+  bool matchChoice(const Opt &opt, const char *str, long &value) const;
+
+  // range bound (empty is unbounded)
+  static bool toBound(const char *str, double def, double &r) {
+    if (*str == '\0') {
+      r = def;
+      return true;
+    }
+
+    return toReal(str, r);
+  }
+
+  static bool toReal(const char *str, double &r) {
+    char *end;
+
+    r = strtod(str, &end);
+
+    return (end != str && *end == '\0');
+  }
+
+ private:
+  Opt    opts_[MaxOpts];
+  size_t numOpts_     { 0 };
+  size_t positionals_[MaxPos > 0 ? MaxPos : 1] { };
+  size_t numPos_      { 0 };
+  char   bytes_[MaxBytes > 0 ? MaxBytes : 1];
+  size_t bytesUsed_   { 0 }; // used by parse
+  size_t formatBytes_ { 0 }; // used by format (defaults)
+  Error  error_       { ERROR_NONE };
+  int    errorIndex_  { -1 };
+  int    errorOption_ { -1 };
+};
+
+//------
+
+template<size_t MaxOpts, size_t MaxPos, size_t MaxBytes>
+const char *
+CArgsFixed<MaxOpts, MaxPos, MaxBytes>::
+errorMessage(Error error)
+{
+  switch (error) {
+    case ERROR_NONE                : return "";
+    case ERROR_FORMAT              : return "Invalid format";
+    case ERROR_TOO_MANY_OPTIONS    : return "Too many options";
+    case ERROR_TOO_MANY_POSITIONALS: return "Too many positionals";
+    case ERROR_TOO_MANY_BYTES      : return "String space exceeded";
+    case ERROR_UNKNOWN_OPTION      : return "Unrecognised argument";
+    case ERROR_MISSING_VALUE       : return "Missing value";
+    case ERROR_INVALID_VALUE       : return "Invalid value";
+    case ERROR_REQUIRED            : return "Required argument not supplied";
+    default                        : return "";
+  }
+}
+
+template<size_t MaxOpts, size_t MaxPos, size_t MaxBytes>
+bool
+CArgsFixed<MaxOpts, MaxPos, MaxBytes>::
+setFormat(const char *format)
+{
+  numOpts_     = 0;
+  numPos_      = 0;
+  bytesUsed_   = 0;
+  formatBytes_ = 0;
+
+  fail(ERROR_NONE);
+
+  std::string_view def(format ? format : "");
+
+  size_t i = 0;
+
+  while (i < def.size()) {
+    while (i < def.size() && isspace(def[i]))
+      ++i;
+
+    if (i >= def.size())
+      break;
+
+    if (def[i] != '-')
+      return fail(ERROR_FORMAT, int(i));
+
+    if (numOpts_ >= MaxOpts)
+      return fail(ERROR_TOO_MANY_OPTIONS, int(i));
+
+    Opt &opt = opts_[numOpts_];
+
+    opt = Opt();
+
+    //---
+
+    size_t j = i++;
+
+    while (i < def.size() && def[i] == '-')
+      ++i;
+
+    if (i >= def.size() || ! isalnum(def[i]))
+      return fail(ERROR_FORMAT, int(i));
+
+    while (i < def.size() && (isalnum(def[i]) || def[i] == '_'))
+      ++i;
+
+    opt.name = def.substr(j, i - j);
+
+    //---
+
+    if (i < def.size() && def[i] == ':') {
+      ++i;
+
+      char c = (i < def.size() ? def[i] : '\0');
+
+      if (! strchr("fiIrRsScC", c) || c == '\0')
+        return fail(ERROR_FORMAT, int(i));
+
+      opt.type     = char(tolower(c));
+      opt.attached = isupper(c);
+
+      if (opt.type == 'c') {
+        if (++i >= def.size() || def[i] != '[')
+          return fail(ERROR_FORMAT, int(i));
+
+        size_t jj = ++i;
+
+        while (i < def.size() && def[i] != ']')
+          ++i;
+
+        if (i >= def.size())
+          return fail(ERROR_FORMAT, int(i));
+
+        opt.choices = def.substr(jj, i - jj);
+      }
+
+      ++i;
+
+      if (i < def.size() && def[i] == '{') {
+        if (opt.type != 'i' && opt.type != 'r')
+          return fail(ERROR_FORMAT, int(i));
+
+        // min and max are converted from (null terminated) copy
+        char   buffer[64];
+        size_t jj = ++i;
+
+        while (i < def.size() && def[i] != '}')
+          ++i;
+
+        if (i >= def.size() || i - jj >= sizeof(buffer))
+          return fail(ERROR_FORMAT, int(i));
+
+        memcpy(buffer, &def[jj], i - jj);
+
+        buffer[i - jj] = '\0';
+
+        char *comma = strchr(buffer, ',');
+
+        if (! comma)
+          return fail(ERROR_FORMAT, int(jj));
+
+        *comma = '\0';
+
+        double inf = std::numeric_limits<double>::infinity();
+
+        if (! toBound(buffer, -inf, opt.min) || ! toBound(comma + 1, inf, opt.max))
+          return fail(ERROR_FORMAT, int(jj));
+
+        opt.hasRange = true;
+
+        ++i;
+      }
+
+      // patterns (regex), counts and multiple values need allocation
+      while (i < def.size() && (def[i] == 'n' || def[i] == 'r' || def[i] == 's')) {
+        if      (def[i] == 'n') opt.noCase   = true;
+        else if (def[i] == 'r') opt.required = true;
+
+        ++i;
+      }
+
+      if (i < def.size() && def[i] != '=' && ! isspace(def[i]))
+        return fail(ERROR_FORMAT, int(i));
+    }
+
+    //---
+
+    opt.defval.i = (opt.type == 's' ? -1 : 0);
+
+    if (i < def.size() && def[i] == '=') {
+      size_t jj = ++i;
+
+      while (i < def.size() && ! isspace(def[i])) {
+        if (def[i] == '\\')
+          ++i;
+
+        ++i;
+      }
+
+      if (i > def.size())
+        i = def.size();
+
+      if (opt.type == 's') {
+        opt.defval.i = addString(&def[jj], i - jj, /*unescape*/true);
+
+        if (opt.defval.i < 0)
+          return fail(ERROR_TOO_MANY_BYTES, int(jj));
+      }
+      else {
+        char buffer[64];
+
+        if (i - jj >= sizeof(buffer))
+          return fail(ERROR_FORMAT, int(jj));
+
+        memcpy(buffer, &def[jj], i - jj);
+
+        buffer[i - jj] = '\0';
+
+        if (! setValue(opt, buffer, opt.defval))
+          return fail(ERROR_FORMAT, int(jj));
+      }
+    }
+
+    opt.value = opt.defval;
+
+    //---
+
+    // description (ignored)
+    j = i;
+
+    while (j < def.size() && isspace(def[j]))
+      ++j;
+
+    if (j < def.size() && def[j] == '(') {
+      i = j + 1;
+
+      while (i < def.size() && def[i] != ')') {
+        if (def[i] == '\\')
+          ++i;
+
+        ++i;
+      }
+
+      if (i < def.size())
+        ++i;
+    }
+
+    ++numOpts_;
+  }
+
+  formatBytes_ = bytesUsed_;
+
+  return true;
+}
+
+template<size_t MaxOpts, size_t MaxPos, size_t MaxBytes>
+bool
+CArgsFixed<MaxOpts, MaxPos, MaxBytes>::
+parse(int argc, const char * const *argv)
+{
+  // reset values from previous parse
+  for (size_t i = 0; i < numOpts_; ++i) {
+    opts_[i].value = opts_[i].defval;
+    opts_[i].set   = false;
+  }
+
+  numPos_    = 0;
+  bytesUsed_ = formatBytes_;
+
+  fail(ERROR_NONE);
+
+  bool skip_remaining = false;
+
+  auto addPositional = [&](int i) {
+    if (numPos_ >= MaxPos)
+      return fail(ERROR_TOO_MANY_POSITIONALS, i);
+
+    long pos = addString(argv[i], strlen(argv[i]));
+
+    if (pos < 0)
+      return fail(ERROR_TOO_MANY_BYTES, i);
+
+    positionals_[numPos_++] = size_t(pos);
+
+    return true;
+  };
+
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+
+    if (skip_remaining || arg[0] != '-' || arg[1] == '\0') {
+      if (! addPositional(i))
+        return false;
+
+      continue;
+    }
+
+    if (strcmp(arg, "--") == 0) {
+      skip_remaining = true;
+      continue;
+    }
+
+    // exact name or attached name prefix (first match in definition order)
+    size_t len = strlen(arg);
+    int    id  = -1;
+
+    for (size_t j = 0; j < numOpts_; ++j) {
+      const Opt &opt = opts_[j];
+
+      if (opt.attached) {
+        if (len > opt.name.size() && matchName(opt, arg, opt.name.size())) {
+          id = int(j);
+          break;
+        }
+      }
+      else if (len == opt.name.size() && matchName(opt, arg, len)) {
+        id = int(j);
+        break;
+      }
+    }
+
+    if (id < 0) {
+      // combined single letter flags (e.g. -abc)
+      for (size_t k = 1; k < len; ++k) {
+        int fid = -1;
+
+        for (size_t j = 0; j < numOpts_; ++j) {
+          const Opt &opt = opts_[j];
+
+          if (opt.type == 'f' && opt.name.size() == 2 && opt.name[1] == arg[k]) {
+            fid = int(j);
+            break;
+          }
+        }
+
+        if (fid < 0)
+          return fail(ERROR_UNKNOWN_OPTION, i);
+
+        opts_[fid].value.i = 1;
+        opts_[fid].set     = true;
+      }
+
+      continue;
+    }
+
+    Opt &opt = opts_[id];
+
+    if (opt.type == 'f') {
+      opt.value.i = 1;
+      opt.set     = true;
+
+      continue;
+    }
+
+    const char *value;
+
+    if (opt.attached)
+      value = arg + opt.name.size();
+    else {
+      if (i + 1 >= argc)
+        return fail(ERROR_MISSING_VALUE, i, id);
+
+      value = argv[++i];
+    }
+
+    if (opt.type == 's') {
+      opt.value.i = addString(value, strlen(value));
+
+      if (opt.value.i < 0)
+        return fail(ERROR_TOO_MANY_BYTES, i, id);
+    }
+    else if (! setValue(opt, value, opt.value))
+      return fail(ERROR_INVALID_VALUE, i, id);
+
+    opt.set = true;
+  }
+
+  for (size_t j = 0; j < numOpts_; ++j)
+    if (opts_[j].required && ! opts_[j].set)
+      return fail(ERROR_REQUIRED, -1, int(j));
+
+  return true;
+}
+
+// convert (non string) value
+template<size_t MaxOpts, size_t MaxPos, size_t MaxBytes>
+bool
+CArgsFixed<MaxOpts, MaxPos, MaxBytes>::
+setValue(Opt &opt, const char *str, Value &value)
+{
+  if      (opt.type == 'f') {
+    value.i = (strcmp(str, "1") == 0 || strcmp(str, "true") == 0);
+  }
+  else if (opt.type == 'i') {
+    char *end;
+
+    value.i = strtol(str, &end, 10);
+
+    if (end == str || *end != '\0')
+      return false;
+
+    if (opt.hasRange && (value.i < opt.min || value.i > opt.max))
+      return false;
+  }
+  else if (opt.type == 'r') {
+    if (! toReal(str, value.r))
+      return false;
+
+    if (opt.hasRange && (value.r < opt.min || value.r > opt.max))
+      return false;
+  }
+  else if (opt.type == 'c') {
+    if (! matchChoice(opt, str, value.i))
+      return false;
+  }
+
+  return true;
+}
+
+// choice value is index of choice or value of 'label=value' choice
+template<size_t MaxOpts, size_t MaxPos, size_t MaxBytes>
+bool
+CArgsFixed<MaxOpts, MaxPos, MaxBytes>::
+matchChoice(const Opt &opt, const char *str, long &value) const
+{
+  std::string_view choices = opt.choices;
+
+  size_t len = strlen(str);
+  long   ind = 0;
+
+  for (size_t k = 0; k < choices.size(); ) {
+    while (k < choices.size() && (choices[k] == ' ' || choices[k] == ','))
+      ++k;
+
+    size_t kk = k;
+
+    while (k < choices.size() && choices[k] != ' ' && choices[k] != ',')
+      ++k;
+
+    if (k == kk)
+      break;
+
+    std::string_view choice = choices.substr(kk, k - kk);
+    std::string_view label  = choice.substr(0, choice.find('='));
+
+    bool match = (label.size() == len);
+
+    for (size_t j = 0; match && j < len; ++j) {
+      if (opt.noCase)
+        match = (tolower(label[j]) == tolower(str[j]));
+      else
+        match = (label[j] == str[j]);
+    }
+
+    if (match) {
+      value = ind;
+
+      if (label.size() < choice.size())
+        value = strtol(choice.data() + label.size() + 1, nullptr, 10);
+
+      return true;
+    }
+
+    ++ind;
+  }
+
+  return false;
+}
+
+#endif
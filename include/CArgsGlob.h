@@ -0,0 +1,25 @@
+#ifndef CARGS_GLOB_H
+#define CARGS_GLOB_H
+
+#include <string>
+#include <vector>
+
+// Expand shell glob patterns ('*', '?', '[...]' in path components) for
+// positional arguments. Directories are read by a pool of threads, the
+// matches of each pattern are sorted (so the order is deterministic) and a
+// pattern with no matches is returned unchanged (like the shell). A
+// backslash escapes a wildcard character and a trailing '/' only matches
+// directories. Threads are only started while there are more directories
+// to read than idle threads.
+class CArgsGlob {
+ public:
+  typedef std::vector<std::string> StringList;
+
+ public:
+  static bool isPattern(const std::string &str);
+
+  // append expansion of each pattern (in order) to results
+  static void expand(const StringList &patterns, StringList &results, int numThreads=0);
+};
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef CARGS_LAYERS_H
+#define CARGS_LAYERS_H
+
+#include <CArgs.h>
+#include <functional>
+
+// Option values merged from several sources in increasing precedence
+// (defaults < config file < environment < command line).
+//
+// Each source is parsed once (into its own CArgs) and the options it sets
+// are copied into a layer. A layer stores a bitset of the option ids it sets
+// and a dense array with a value for each set bit (in id order), so the
+// value for an id is at the rank (count of set bits before it) of its bit.
+// Word ranks are precomputed so a lookup by id is a few bit tests (topmost
+// layer with the bit set), a popcount and an array read with no string work.
+// The layer of each value is available (getLayer) to report where it came from.
+//
+// Required options are not checked when a source is parsed (they can be set
+// by any layer); call checkRequired once all sources have been parsed.
+class CArgsLayers {
+ public:
+  enum Layer {
+    LAYER_DEFAULTS,
+    LAYER_CONFIG,
+    LAYER_ENV,
+    LAYER_ARGV,
+    NUM_LAYERS
+  };
+
+  typedef std::vector<std::string>      StringList;
+  typedef std::function<void (CArgs &)> InitProc;
+
+ public:
+  // optional init proc is called for each new CArgs before format is set
+  // (e.g. to register types)
+  CArgsLayers(const std::string &def, const InitProc &initProc=InitProc());
+
+  CArgsLayers(const CArgsLayers &) = delete;
+  CArgsLayers &operator=(const CArgsLayers &) = delete;
+
+  // set layer from options set in a parsed CArgs of the same format (all
+  // options for defaults layer). Replaces any previous values of layer.
+  void setLayer(Layer layer, const CArgs &cargs);
+
+  void clearLayer(Layer layer);
+
+  // parse file (response file syntax) into config layer
+  bool parseConfig(const std::string &filename);
+
+  // parse environment into env layer. Option name (without leading '-')
+  // is upper cased with other non alphanumerics replaced by '_' and added
+  // to prefix, e.g. '-jobs' with prefix 'APP_' is 'APP_JOBS'.
+  // A flag is set by any value other than '', '0' or 'false'.
+  bool parseEnv(const std::string &prefix);
+
+  // parse command line into argv layer (optionally expanding @<file> arguments)
+  bool parseArgv(int argc, char **argv, bool responseFiles=false);
+
+  // report required options not set by any layer
+  bool checkRequired() const;
+
+  //---
+
+  const CArgs &getSpec() const { return spec_; }
+
+  int getNumArgs() const { return numArgs_; }
+
+  int getArgIndex(const std::string &name) const { return spec_.getArgIndex(name); }
+
+  // top most layer which sets option
+  Layer getLayer(int id) const;
+
+  // option set by a layer above defaults
+  bool isSet(int id) const { return getLayer(id) != LAYER_DEFAULTS; }
+
+  static const char *layerName(Layer layer);
+
+  // non-option arguments of layer (positionals are not merged)
+  const StringList &getPositionals(Layer layer=LAYER_ARGV) const {
+    return layers_[layer].positionals; }
+
+  //---
+
+  // value from top most layer which sets option (lists are not merged)
+  bool              getBoolean   (int id) const { return value(id, CARG_TYPE_BOOLEAN).value != 0; }
+  long              getInteger   (int id) const { return value(id, CARG_TYPE_INTEGER).value; }
+  double            getReal      (int id) const;
+  long              getChoice    (int id) const { return value(id, CARG_TYPE_CHOICE  ).value; }
+  long              getSize      (int id) const { return value(id, CARG_TYPE_SIZE    ).value; }
+  long              getDuration  (int id) const { return value(id, CARG_TYPE_DURATION).value; }
+  double            getRate      (int id) const;
+  std::string_view  getString    (int id) const;
+  const StringList &getStringList(int id) const;
+  const StringList &getPathList  (int id) const { return value(id, CARG_TYPE_PATH).strs; }
+
+  template<typename T> T getCustom(int id) const {
+    const Value &v = value(id, CARG_TYPE_CUSTOM);
+
+    T t = T();
+
+    if (v.str.size() == sizeof(T))
+      memcpy(&t, v.str.data(), sizeof(T));
+
+    return t;
+  }
+
+ private:
+  struct Value {
+    int64_t     value  { 0 }; // boolean, integer, choice, size, duration, rate count, real bits
+    int64_t     value2 { 0 }; // rate period
+    std::string str;          // string, custom bytes
+    StringList  strs;         // string list, path
+  };
+
+  struct LayerData {
+    std::vector<uint64_t> bits;   // set option ids
+    std::vector<uint32_t> ranks;  // number of set bits before each word
+    std::vector<Value>    values; // value per set bit (in id order)
+    StringList            positionals;
+  };
+
+  bool parseLayer(Layer layer, std::vector<std::string> &args, bool responseFiles=false);
+
+  const Value &value(int id, CArgType type) const;
+
+  static void getValue(const CArg *arg, Value &value);
+
+ private:
+  std::string           def_;
+  InitProc              initProc_;
+  CArgs                 spec_;
+  int                   numArgs_ { 0 };
+  std::vector<CArgType> types_;
+  LayerData             layers_[NUM_LAYERS];
+};
+
+#endif
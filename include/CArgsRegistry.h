@@ -0,0 +1,64 @@
+#ifndef CARGS_REGISTRY_H
+#define CARGS_REGISTRY_H
+
+#include <CArgs.h>
+
+// Options declared in any translation unit (near the code that uses them)
+// with CARGS_DEFINE, e.g.
+//
+//   CARGS_DEFINE("-verbose:f (verbose output)");
+//   CARGS_DEFINE("-log:s=out.log (log file)");
+//
+// and combined into one option list by CArgsRegistry:
+//
+//   int main(int argc, char **argv) {
+//     CArgs &cargs = CArgsRegistry::args();
+//
+//     cargs.parse(&argc, argv);
+//     ...
+//   }
+//
+// Each CARGS_DEFINE is a constant initialized POD entry placed (by the
+// compiler) in the "cargs_spec" linker section, so there are no static
+// constructors and no initialization order issues. The linker provides the
+// section bounds (__start_cargs_spec/__stop_cargs_spec) and the entries are
+// only sorted (by file, line and order in file, so the order does not depend
+// on link order) and combined on the first call to CArgsRegistry.
+//
+// Note: the linker only includes objects from a static library if they
+// resolve an undefined symbol, so entries in an otherwise unreferenced object
+// of a static library are dropped (link with --whole-archive or use a shared
+// library/object files). Requires GCC or Clang with an ELF linker.
+struct CArgsSpecEntry {
+  const char *spec;
+  const char *file;
+  int         line;
+  int         counter; // order in file (several entries can be on one line)
+};
+
+#define CARGS_CONCAT1(a, b) a##b
+#define CARGS_CONCAT(a, b) CARGS_CONCAT1(a, b)
+
+#define CARGS_DEFINE1(SPEC, COUNTER) \
+  __attribute__((section("cargs_spec"), used, aligned(alignof(CArgsSpecEntry)))) \
+  static const CArgsSpecEntry CARGS_CONCAT(cargs_spec_entry_, COUNTER) = \
+    { SPEC, __FILE__, __LINE__, COUNTER }
+
+#define CARGS_DEFINE(SPEC) CARGS_DEFINE1(SPEC, __COUNTER__)
+
+class CArgsRegistry {
+ public:
+  typedef std::vector<const CArgsSpecEntry *> EntryList;
+
+ public:
+  // all entries (sorted by file, line and order in file)
+  static const EntryList &entries();
+
+  // combined spec of all entries
+  static const std::string &spec();
+
+  // options for combined spec (created on first call)
+  static CArgs &args();
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef CARGS_STRUCT_H
+#define CARGS_STRUCT_H
+
+#include <CArgs.h>
+
+// Struct of option values generated from one option list (X macro) so the
+// format string, the struct fields and the code which reads the values
+// cannot get out of step, e.g.
+/*
+     #define TOOL_OPTIONS(X) \
+       X(verbose, Boolean , ""              , "verbose output" ) \
+       X(jobs   , Integer , "{1,64}=4"      , "number of jobs" ) \
+       X(scale  , Real    , "=1.5"          , "scale factor"   ) \
+       X(codec  , Choice  , "[h264,vp9,av1]", "output codec"   ) \
+       X(log    , String  , "=out.log"      , "log file"       ) \
+       X(timeout, Duration, "=250ms"        , "request timeout")
+
+     CARGS_STRUCT(ToolOptions, TOOL_OPTIONS)
+
+     int main(int argc, char **argv) {
+       ToolOptions opts;
+
+       if (! opts.cargsParse(argc, argv))
+         exit(1);
+
+       if (opts.verbose) ...
+*/
+// Each entry is (field name, type, format after the type letter, description)
+// and defines option '-<field name>' and a field of the matching C++ type
+// (Boolean bool, Integer/Choice/Size/Duration long, Real/Rate double and
+// String/Path std::string). The format is a string literal built at compile
+// time (cargsSpec). cargsBind sets the format of a CArgs, initializes the
+// fields from the defaults (by option index) and sets an action for each
+// option which writes the field as it is parsed, so values are read as plain
+// struct fields with no lookup. The CArgs must not be parsed after the struct
+// is destroyed. Lists (m flag) and attached (upper case) types are not
+// supported (the last value of a list is stored).
+
+#define CARGS_STRUCT_TYPE_Boolean  bool
+#define CARGS_STRUCT_TYPE_Integer  long
+#define CARGS_STRUCT_TYPE_Real     double
+#define CARGS_STRUCT_TYPE_String   std::string
+#define CARGS_STRUCT_TYPE_Choice   long
+#define CARGS_STRUCT_TYPE_Size     long
+#define CARGS_STRUCT_TYPE_Duration long
+#define CARGS_STRUCT_TYPE_Rate     double
+#define CARGS_STRUCT_TYPE_Path     std::string
+
+#define CARGS_STRUCT_ARG_Boolean  bool
+#define CARGS_STRUCT_ARG_Integer  long
+#define CARGS_STRUCT_ARG_Real     double
+#define CARGS_STRUCT_ARG_String   const std::string &
+#define CARGS_STRUCT_ARG_Choice   long
+#define CARGS_STRUCT_ARG_Size     long
+#define CARGS_STRUCT_ARG_Duration long
+#define CARGS_STRUCT_ARG_Rate     double
+#define CARGS_STRUCT_ARG_Path     const std::string &
+
+#define CARGS_STRUCT_LETTER_Boolean  "f"
+#define CARGS_STRUCT_LETTER_Integer  "i"
+#define CARGS_STRUCT_LETTER_Real     "r"
+#define CARGS_STRUCT_LETTER_String   "s"
+#define CARGS_STRUCT_LETTER_Choice   "c"
+#define CARGS_STRUCT_LETTER_Size     "b"
+#define CARGS_STRUCT_LETTER_Duration "t"
+#define CARGS_STRUCT_LETTER_Rate     "q"
+#define CARGS_STRUCT_LETTER_Path     "p"
+
+#define CARGS_STRUCT_FIELD(NAME, TYPE, SPEC, DESC) \
+  CARGS_STRUCT_TYPE_##TYPE NAME { };
+
+#define CARGS_STRUCT_SPEC(NAME, TYPE, SPEC, DESC) \
+  "-" #NAME ":" CARGS_STRUCT_LETTER_##TYPE SPEC " (" DESC ") "
+
+#define CARGS_STRUCT_BIND(NAME, TYPE, SPEC, DESC) \
+  NAME = CArgsStructUtil::get##TYPE(cargs, id++); \
+  cargs.set##TYPE##Action("-" #NAME, \
+    [this](CARGS_STRUCT_ARG_##TYPE value) { NAME = value; });
+
+#define CARGS_STRUCT(NAME, LIST) \
+  struct NAME { \
+    LIST(CARGS_STRUCT_FIELD) \
+  \
+    static const char *cargsSpec() { return LIST(CARGS_STRUCT_SPEC) ""; } \
+  \
+    void cargsBind(CArgs &cargs) { \
+      cargs.setFormat(cargsSpec()); \
+  \
+      int id = 0; \
+  \
+      LIST(CARGS_STRUCT_BIND) \
+    } \
+  \
+    bool cargsParse(CArgs &cargs, int argc, char **argv) { \
+      cargsBind(cargs); \
+  \
+      return cargs.parse(argc, argv); \
+    } \
+  \
+    bool cargsParse(int argc, char **argv) { \
+      CArgs cargs; \
+  \
+      return cargsParse(cargs, argc, argv); \
+    } \
+  };
+
+// default values by option index
+namespace CArgsStructUtil {
+  inline bool   getBoolean (const CArgs &cargs, int id) { return cargs.getBooleanArg (id); }
+  inline long   getInteger (const CArgs &cargs, int id) { return cargs.getIntegerArg (id); }
+  inline double getReal    (const CArgs &cargs, int id) { return cargs.getRealArg    (id); }
+  inline long   getChoice  (const CArgs &cargs, int id) { return cargs.getChoiceArg  (id); }
+  inline long   getSize    (const CArgs &cargs, int id) { return cargs.getSizeArg    (id); }
+  inline long   getDuration(const CArgs &cargs, int id) { return cargs.getDurationArg(id); }
+  inline double getRate    (const CArgs &cargs, int id) { return cargs.getRateArg    (id); }
+
+  inline std::string getString(const CArgs &cargs, int id) { return cargs.getStringArg(id); }
+
+  inline std::string getPath(const CArgs &cargs, int id) {
+    return std::string(static_cast<const CArgPath *>(cargs.getArg(id))->getValue());
+  }
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef CARGS_TOKENIZER_H
+#define CARGS_TOKENIZER_H
+
+#include <string>
+#include <vector>
+
+// Split a command string into words like the POSIX shell (without any
+// expansion): words are separated by unquoted whitespace, '...' quotes all
+// characters, "..." quotes all characters except '\' before '$', '`', '"',
+// '\' or newline, an unquoted '\' quotes the next character, '\' newline is
+// removed (line continuation) and an unquoted '#' at the start of a word
+// starts a comment to the end of the line.
+//
+// The string is copied once into an internal buffer which is unescaped in
+// place in a single pass (the unescaped text is never longer than the
+// original) and the null terminated words are returned as an argv style
+// array of pointers into the buffer. The buffer and array are reused by the
+// next call so no allocation is done per word (or per call once the buffer
+// is large enough).
+class CArgsTokenizer {
+ public:
+  CArgsTokenizer() { }
+
+  // split string (optional arg0 is added as argv[0], e.g. program name
+  // for CArgs::parse). Returns false on unterminated quote.
+  bool tokenize(const std::string &str, const char *arg0=nullptr) {
+    return tokenize(str.c_str(), str.size(), arg0);
+  }
+
+  bool tokenize(const char *str, size_t len, const char *arg0=nullptr);
+
+  // words of last tokenize (argv is null terminated, valid until next tokenize)
+  int    argc() const { return int(argv_.size()) - 1; }
+  char **argv() { return &argv_[0]; }
+
+  const std::string &getError() const { return error_; }
+
+ private:
+  std::vector<char>   buffer_;
+  std::vector<char *> argv_ { nullptr };
+  std::string         error_;
+};
+
+#endif
@@ -0,0 +1,267 @@
+#ifndef CARGS_VIEW_H
+#define CARGS_VIEW_H
+
+#include <CArgs.h>
+#include <string_view>
+
+// Frozen read-only copy of the options (and positionals) of a parsed CArgs.
+//
+// Thread safety: once constructed a CArgsView is never modified so all const
+// methods can be called from any number of threads concurrently. Lookups by
+// option id (the option's index in the CArgs) are a bounds check and an
+// array read; lookups by name are a probe of a precomputed hash table. Reads
+// do no locking, allocation or reference counting, and the data is one 64 byte
+// aligned block so there are no shared writes to cause cache line contention.
+//
+// The data is a single position independent block (offsets, no pointers) in
+// native byte order so it can be passed to another process (e.g. forked
+// workers) through a pipe, memfd or (as text) an environment variable and
+// used directly (no parsing of values) after an O(size) validation.
+// Fields read when getting values (value, type, flags and name hash) are
+// stored as separate arrays (structure of arrays) at the start of the block
+// so reading the values of many options touches few cache lines. Names,
+// descriptions, positionals and string data follow in a cold section.
+class CArgsView {
+ public:
+  // option which differs between two views
+  struct Change {
+    int              id       { -1 };
+    bool             oldSet   { false };
+    bool             newSet   { false };
+    std::string_view oldValue; // value text (views of view data)
+    std::string_view newValue;
+  };
+
+  typedef std::vector<Change> Changes;
+
+ public:
+  CArgsView(const CArgs &cargs);
+
+  // copy of serialized view data (data()/size() of another view). Invalid
+  // data is reported (CTHROW) and gives an empty view.
+  CArgsView(const void *data, size_t size);
+
+ ~CArgsView();
+
+  CArgsView(const CArgsView &) = delete;
+  CArgsView &operator=(const CArgsView &) = delete;
+
+  //---
+
+  int numOptions() const { return numOptions_; }
+
+  // option id for name (-1 if not found)
+  int lookup(const std::string_view &name) const;
+
+  std::string_view getName(int id) const { return str(names_[checkId(id)]); }
+  std::string_view getDesc(int id) const { return str(descs_[checkId(id)]); }
+
+  CArgType getType(int id) const { return CArgType(types_[checkId(id)]); }
+
+  bool isSet     (int id) const { return flags_[checkId(id)] & FLAG_SET; }
+  bool isAttached(int id) const { return flags_[checkId(id)] & FLAG_ATTACHED; }
+
+  // value as shell quoted text (space separated for lists, choice name for choice)
+  std::string_view getValueText(int id) const { return str(texts_[checkId(id)]); }
+
+  //---
+
+  bool   getBoolean (int id) const { return value(id, CARG_TYPE_BOOLEAN ) != 0; }
+  long   getInteger (int id) const { return value(id, CARG_TYPE_INTEGER ); }
+  double getReal    (int id) const;
+  long   getChoice  (int id) const { return value(id, CARG_TYPE_CHOICE  ); }
+  long   getSize    (int id) const { return value(id, CARG_TYPE_SIZE    ); }
+  long   getDuration(int id) const { return value(id, CARG_TYPE_DURATION); }
+  double getRate    (int id) const;
+
+  // string, string list and path (last value)
+  std::string_view getString(int id) const;
+
+  int              getStringListSize (int id) const;
+  std::string_view getStringListValue(int id, int i) const;
+
+  template<typename T> T getCustom(int id) const {
+    int64_t offset = value(id, CARG_TYPE_CUSTOM);
+
+    if (size_t(values2_[checkId(id)]) != sizeof(T))
+      return (badValue(id, CARG_TYPE_CUSTOM), T());
+
+    T value;
+
+    memcpy(&value, data_ + offset, sizeof(T));
+
+    return value;
+  }
+
+  //---
+
+  bool             getBooleanArg (const std::string_view &name) const;
+  long             getIntegerArg (const std::string_view &name) const;
+  double           getRealArg    (const std::string_view &name) const;
+  std::string_view getStringArg  (const std::string_view &name) const;
+  long             getChoiceArg  (const std::string_view &name) const;
+  long             getSizeArg    (const std::string_view &name) const;
+  long             getDurationArg(const std::string_view &name) const;
+  double           getRateArg    (const std::string_view &name) const;
+
+  //---
+
+  int numPositionals() const { return int(header_->numPositionals); }
+
+  std::string_view getPositional(int i) const;
+
+  //---
+
+  const char *data() const { return data_; }
+  size_t      size() const { return size_; }
+
+  // hash of format string of options (views with same hash are comparable)
+  uint64_t specHash() const { return header_->specHash; }
+
+  // fingerprint of option values (sum of option fingerprints, equal to
+  // CArgs::getFingerprint if values were only set by parse)
+  CArgFingerprint fingerprint() const {
+    CArgFingerprint fp;
+
+    fp.lo = header_->fingerprintLo;
+    fp.hi = header_->fingerprintHi;
+
+    return fp;
+  }
+
+  // Options whose value or set flag differ between views of the same spec
+  // (CTHROW if spec hashes differ). Views with the same fingerprint have no
+  // changes, otherwise blocks of options with equal value hashes are skipped.
+  static bool diff(const CArgsView &oldView, const CArgsView &newView, Changes &changes);
+
+  // check serialized data (error set if invalid)
+  static bool validate(const void *data, size_t size, std::string &error);
+
+  // data as text (base64) e.g. for an environment variable
+  std::string toString() const;
+
+  // view from text (null if not valid base64 or view data)
+  static std::unique_ptr<CArgsView> fromString(const std::string_view &str);
+
+  //---
+
+  // Shared memory: the data is written once to a sealed memfd (passed to
+  // workers by fork, exec or SCM_RIGHTS) or, for a name starting with '/', a
+  // POSIX shared memory object (opened by name, removed with shm_unlink).
+  // Workers map a memfd read only and use the view directly (no per process
+  // copy) as it is sealed so its data cannot change after it is validated.
+  // A shared memory object can be opened for writing by its owner so its
+  // data is copied (and the copy validated) instead.
+  // (shm_open needs -lrt with glibc before 2.34)
+
+  // create shared memory with view data (returns read only file descriptor
+  // for shared memory object, or -1)
+  int createShared(const std::string &name) const;
+
+  // view of shared memory (null if data invalid)
+  static std::unique_ptr<CArgsView> mapShared(int fd);
+  static std::unique_ptr<CArgsView> openShared(const std::string &name);
+
+  // print bytes used (total and per option) by each section
+  void printMemory(std::ostream &os=std::cout) const;
+
+ private:
+  enum {
+    FLAG_SET      = (1<<0),
+    FLAG_ATTACHED = (1<<1),
+    FLAG_NO_CASE  = (1<<2),
+    FLAG_LIST     = (1<<3)
+  };
+
+  struct StrRef {
+    uint32_t offset { 0 };
+    uint32_t len    { 0 };
+  };
+
+  // Values are stored in values (bool, integer, choice, size, duration, rate
+  // count, real bits) or values/values2 (string, custom or list of StrRef
+  // offset/length and rate count/period).
+  struct Header {
+    uint32_t magic             { 0 };
+    uint16_t version           { 0 };
+    uint16_t headerSize        { 0 };
+    uint32_t size              { 0 };
+    uint32_t numOptions        { 0 };
+    uint32_t numPositionals    { 0 };
+    uint32_t hashSize          { 0 };
+    uint64_t specHash          { 0 };
+    uint64_t fingerprintLo     { 0 };
+    uint64_t fingerprintHi     { 0 };
+    // hot (int64_t, int64_t, uint64_t, uint32_t, uint8_t, uint8_t per option)
+    uint32_t valuesOffset      { 0 };
+    uint32_t values2Offset     { 0 };
+    uint32_t valueHashesOffset { 0 };
+    uint32_t nameHashesOffset  { 0 };
+    uint32_t typesOffset       { 0 };
+    uint32_t flagsOffset       { 0 };
+    uint32_t hashOffset        { 0 };
+    // cold
+    uint32_t namesOffset       { 0 };
+    uint32_t descsOffset       { 0 };
+    uint32_t textsOffset       { 0 };
+    uint32_t positionalsOffset { 0 };
+    uint32_t stringsOffset     { 0 };
+  };
+
+  // view of mapped memory (unmapped on destruction)
+  struct Mapped { };
+
+  CArgsView(const char *data, size_t size, Mapped);
+
+  void build(const CArgs &cargs);
+
+  void init();
+
+  int checkId(int id) const {
+    if (id < 0 || id >= numOptions_)
+      return badId(id);
+
+    return id;
+  }
+
+  int64_t value(int id, CArgType type) const {
+    if (id < 0 || id >= numOptions_ || types_[id] != type)
+      return badValue(id, type);
+
+    return values_[id];
+  }
+
+  std::string_view str(const StrRef &ref) const {
+    return std::string_view(data_ + ref.offset, ref.len);
+  }
+
+  const StrRef *strList(int id) const {
+    return reinterpret_cast<const StrRef *>(data_ + values_[id]);
+  }
+
+  int lookupName(const std::string_view &name, CArgType type) const;
+
+  // report invalid id or wrong type for id
+  int     badId   (int id) const;
+  int64_t badValue(int id, CArgType type) const;
+
+ private:
+  const char     *data_        { nullptr };
+  size_t          size_        { 0 };
+  bool            mapped_      { false };
+  int             numOptions_  { 0 };
+  const Header   *header_      { nullptr };
+  const int64_t  *values_      { nullptr };
+  const int64_t  *values2_     { nullptr };
+  const uint64_t *valueHashes_ { nullptr };
+  const uint32_t *nameHashes_  { nullptr };
+  const uint8_t  *types_       { nullptr };
+  const uint8_t  *flags_       { nullptr };
+  const int32_t  *hash_        { nullptr };
+  const StrRef   *names_       { nullptr };
+  const StrRef   *descs_       { nullptr };
+  const StrRef   *texts_       { nullptr };
+  const StrRef   *positionals_ { nullptr };
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef CARGS_WATCHER_H
+#define CARGS_WATCHER_H
+
+#include <CArgs.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Config file of options (same syntax as a response file) which is watched
+// (inotify) and re-parsed into a new CArgs when it changes.
+//
+// The current CArgs is published by an atomic pointer swap (RCU style).
+// Readers take a Snapshot which pins the CArgs current at that time; taking
+// and releasing a snapshot is a few atomic loads/stores with no locks (wait
+// free while there are no more than NUM_SLOTS concurrent snapshots). Old
+// CArgs are deleted once no snapshot can still reference them.
+class CArgsWatcher {
+ public:
+  enum { NUM_SLOTS = 128 };
+
+  typedef std::function<void (CArgs &)>       InitProc;
+  typedef std::function<void (const CArgs &)> ChangedProc;
+
+  class Snapshot {
+   public:
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    Snapshot(Snapshot &&rhs) :
+     slot_(rhs.slot_), cargs_(rhs.cargs_) {
+      rhs.slot_ = nullptr;
+    }
+
+   ~Snapshot() {
+      if (slot_)
+        slot_->store(0, std::memory_order_release);
+    }
+
+    const CArgs *get() const { return cargs_; }
+
+    const CArgs &operator*() const { return *cargs_; }
+    const CArgs *operator->() const { return cargs_; }
+
+   private:
+    friend class CArgsWatcher;
+
+    Snapshot(std::atomic<uint64_t> *slot, const CArgs *cargs) :
+     slot_(slot), cargs_(cargs) {
+    }
+
+   private:
+    std::atomic<uint64_t> *slot_  { nullptr };
+    const CArgs           *cargs_ { nullptr };
+  };
+
+ public:
+  CArgsWatcher(const std::string &def, const std::string &filename);
+ ~CArgsWatcher();
+
+  CArgsWatcher(const CArgsWatcher &) = delete;
+  CArgsWatcher &operator=(const CArgsWatcher &) = delete;
+
+  // called for each new CArgs before format is set (e.g. to register types)
+  void setInitProc(const InitProc &proc) { initProc_ = proc; }
+
+  // called (from watch thread) after a new CArgs is published
+  void setChangedProc(const ChangedProc &proc) { changedProc_ = proc; }
+
+  // load file and start watch thread
+  bool start();
+
+  void stop();
+
+  // re-parse file and publish new CArgs if parse succeeds
+  bool reload();
+
+  Snapshot snapshot() const;
+
+  uint64_t generation() const { return generation_.load(std::memory_order_relaxed); }
+
+ private:
+  void watchLoop();
+
+  void reclaim();
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch { 0 };
+  };
+
+  typedef std::pair<const CArgs *, uint64_t> Retired;
+
+  std::string                def_;
+  std::string                filename_;
+  InitProc                   initProc_;
+  ChangedProc                changedProc_;
+  alignas(64)
+  std::atomic<const CArgs *> current_ { nullptr };
+  std::atomic<uint64_t>      epoch_ { 1 };
+  std::atomic<uint64_t>      generation_ { 0 };
+  mutable Slot               slots_[NUM_SLOTS];
+  std::mutex                 mutex_;
+  std::vector<Retired>       retired_;
+  std::thread                thread_;
+  int                        notifyFd_ { -1 };
+  int                        stopFd_[2] { -1, -1 };
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef CARGV_BUILDER_H
+#define CARGV_BUILDER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+class CArgs;
+class CArg;
+
+// Build argv for a child process from the options set in a parsed CArgs and
+// its positional arguments, with optional overrides.
+//
+// The strings are packed into one buffer. If the total size would exceed the
+// argument limit (default sysconf(_SC_ARG_MAX) less the current environment)
+// the trailing arguments are written to a temporary response file which is
+// passed as '@<file>' (the child must enable CArgs::setResponseFiles).
+// Positionals are preceded by '--' if any starts with '-' or '@' and the
+// '--' and all following arguments are in the response file if it is spilled.
+// The response file is removed when the builder is destroyed unless
+// setKeepSpillFile(true) is used.
+class CArgvBuilder {
+ public:
+  typedef std::vector<std::string> StringList;
+
+ public:
+  CArgvBuilder(const CArgs &cargs, const std::string &prog);
+ ~CArgvBuilder();
+
+  CArgvBuilder(const CArgvBuilder &) = delete;
+  CArgvBuilder &operator=(const CArgvBuilder &) = delete;
+
+  // override option value(s) (no values for a flag)
+  void setOption(const std::string &name, const StringList &values=StringList());
+  void setOption(const std::string &name, const std::string &value);
+
+  void removeOption(const std::string &name);
+
+  void setPositionals(const StringList &positionals);
+  void addPositional(const std::string &positional);
+
+  size_t argMax() const { return argMax_; }
+  void setArgMax(size_t n) { argMax_ = n; }
+
+  bool isKeepSpillFile() const { return keepSpillFile_; }
+  void setKeepSpillFile(bool b) { keepSpillFile_ = b; }
+
+  const std::string &spillFile() const { return spillFile_; }
+
+  // build null terminated argv (valid until next build or destruction)
+  char **build();
+
+  int argc() const { return int(argv_.empty() ? 0 : argv_.size() - 1); }
+
+  // Canonical shell quoted command line (program, options in definition order
+  // with overrides applied, then positionals). Each option uses its attached
+  // or unattached style and choices use their names so the same values always
+  // give the same text. If 'defaults' is set unset options are included with
+  // their default values. The text is written to a buffer owned by the builder
+  // (valid until the next call) which is reused so repeated calls do not
+  // normally allocate.
+  const std::string &canonical(bool defaults=false);
+
+  // set options left out of last build or canonical as they have no value
+  // string (custom type without format proc)
+  const StringList &skippedOptions() const { return skipped_; }
+
+  // append shell quoted string
+  static void quote(const std::string &str, std::string &out);
+
+  static size_t defaultArgMax();
+
+ private:
+  struct Override {
+    std::string name;
+    bool        remove { false };
+    StringList  values;
+  };
+
+  const Override *lookupOverride(const std::string_view &name) const;
+
+  // value strings of option (false if option not included)
+  bool optionValues(const CArg *arg, bool defaults, StringList &values);
+
+  void addToken(const std::string_view &str1, const std::string_view &str2="");
+
+  void spill(size_t keep);
+
+  static bool needsDash(const std::string &positional);
+
+  void removeSpillFile();
+
+ private:
+  const CArgs&          cargs_;
+  std::string           prog_;
+  std::vector<Override> overrides_;
+  StringList            positionals_;
+  bool                  positionalsSet_ { false };
+  size_t                argMax_ { 0 };
+  bool                  keepSpillFile_ { false };
+  std::string           spillFile_;
+  std::string           buffer_;
+  std::vector<size_t>   offsets_;
+  std::vector<char *>   argv_;
+  StringList            values_;
+  std::string           canonical_;
+  StringList            skipped_;
+};
+
+#endif
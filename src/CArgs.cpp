@@ -1,20 +1,45 @@
 #include <CArgs.h>
+#include <CArgsGlob.h>
+#include <CArgsTokenizer.h>
 #include <CStrUtil.h>
 #include <CThrow.h>
+#include <regex>
+#include <numeric>
+#include <cmath>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define strndup_m(s,n) \
   strncpy(reinterpret_cast<char *>(calloc((n) + 1, sizeof(char))), s, n)
 
+static std::string
+foldCase(const std::string &str)
+{
+  std::string str1 = str;
+
+  for (auto &c : str1)
+    c = char(tolower(static_cast<unsigned char>(c)));
+
+  return str1;
+}
+
 //
 // The format of the options definition is a space separated list
 // of option definitions of the form:
 //
-//   '-'<name>':'<type>[<count>][<flags>][=<value>]
+//   '-'<name>':'<type>[<check>][<count>][<flags>][=<value>]
 //
 // where
 //
 //   <name>  - Option name
 //   <type>  - Option type
+//   <check> - Value range or pattern
 //   <count> - Value Count
 //   <flags> - Option flags
 //   <value> - Default value
@@ -34,16 +59,51 @@
 //   'S' - attached string    (string arg required)
 //   'c' - unattached choice  (integer arg required)
 //   'C' - attached choice    (integer arg required)
+//   'b' - unattached size    (size arg required)
+//   'B' - attached size      (size arg required)
+//   't' - unattached time    (duration arg required)
+//   'T' - attached time      (duration arg required)
+//   'q' - unattached rate    (rate arg required)
+//   'Q' - attached rate      (rate arg required)
+//   'p' - unattached path    (path arg required)
+//   'P' - attached path      (path arg required)
+//
+// Sizes are a number with an optional unit suffix (B, k/K/kB/KB, Ki/KiB,
+// M/MB, Mi/MiB, G/GB, Gi/GiB, T/TB, Ti/TiB, P/PB, Pi/PiB, E/EB, Ei/EiB)
+// and are stored in bytes. Durations are a number with an optional unit
+// (ns, us, ms, s, m/min, h, d), default seconds, and are stored in
+// nanoseconds. Rates are a number with an optional count suffix (k/K,
+// M, G, T) and optional '/'<unit> period (default per second) e.g. 10k/s.
+// Numbers can have a fractional part (1.5GiB) and overflow is an error.
+//
+// For 'p' or 'P' an optional square bracketed comma separated list of
+// checks (exists, file, dir, readable, writable) can follow. All paths
+// are checked in one parallel batch at the end of the parse.
+//
+// Other (lower case) letters can be registered as custom types using
+// CArgs::registerType before the format is set. The upper case letter is
+// the attached form.
 //
 // For 'c' or 'C' a square bracked space or comma separated list of
 // allowable values must follow. If the name contains an '=' then
 // then the characters before it are taken as the value string and
 // the characters after it as the string representation of the
-// resultant integer value.
+// resultant integer value (e.g. -tz:c[utc=0,gmt=0,est=-5]).
+// Otherwise the value is the index of the choice in the list.
+//
+// For 'i', 'I', 'r' and 'R' an allowable value range can be supplied
+// as '{'<min>','<max>'}' where either bound can be omitted (e.g.
+// -threads:i{1,256}) and an explicit default must be in the range. For
+// 's' and 'S' a regular expression which the whole value must match can
+// be supplied as '/'<pattern>'/' (use '\/' for a literal '/'). The pattern
+// is compiled once when the format is set. Values are checked as they are
+// converted and all failures are reported together at the end of the parse
+// (see CArgs::getErrors).
 //
 // Option flags are :-
 //
-//   'n' - Not case sensitive when matching argument name.
+//   'n' - Not case sensitive when matching argument name (and choice
+//         values for 'c' and 'C').
 //   'r' - Argument required, error is output if no supplied.
 //   's' - Skip Argument (No return argument required, associated
 //         arguments are not removed from the argument list).
@@ -106,6 +166,149 @@
 //       values are extracted. Integers -> 0, Reals -> 0.0,
 //       Strings -> NULL.
 
+std::string_view
+CArgStringPool::
+add(const std::string_view &str)
+{
+  auto len = str.size();
+
+  if (len == 0)
+    return std::string_view();
+
+  // large strings get their own block (before the current block)
+  if (len > BLOCK_SIZE/4) {
+    auto pos = (blocks_.empty() ? blocks_.end() : blocks_.end() - 1);
+
+    auto p = blocks_.emplace(pos, new char [len]);
+
+    memUsage_ += len;
+
+    memcpy(p->get(), str.data(), len);
+
+    return std::string_view(p->get(), len);
+  }
+
+  if (pos_ + len > BLOCK_SIZE) {
+    blocks_.emplace_back(new char [BLOCK_SIZE]);
+
+    memUsage_ += BLOCK_SIZE;
+
+    pos_ = 0;
+  }
+
+  char *p = blocks_.back().get() + pos_;
+
+  memcpy(p, str.data(), len);
+
+  pos_ += len;
+
+  return std::string_view(p, len);
+}
+
+void
+CArgStringPool::
+clear()
+{
+  blocks_.clear();
+
+  pos_      = BLOCK_SIZE;
+  memUsage_ = 0;
+}
+
+//------
+
+namespace {
+
+inline uint64_t
+rotl64(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t
+fmix64(uint64_t k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+
+  return k;
+}
+
+}
+
+// two lanes mixed with 64 bit chunks of data (murmur3 style)
+void
+CArgHasher::
+add(const void *data, std::size_t len)
+{
+  const uint64_t c1 = 0x87c37b91114253d5ULL;
+  const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+  auto p = static_cast<const unsigned char *>(data);
+
+  len_ += len;
+
+  while (len > 0) {
+    uint64_t k1 = 0, k2 = 0;
+
+    size_t n = std::min(len, size_t(8));
+
+    memcpy(&k1, p, n);
+
+    k2 = uint64_t(n);
+
+    k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1_ ^= k1;
+
+    h1_ = rotl64(h1_, 27); h1_ += h2_; h1_ = h1_*5 + 0x52dce729;
+
+    k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2_ ^= k2;
+
+    h2_ = rotl64(h2_, 31); h2_ += h1_; h2_ = h2_*5 + 0x38495ab5;
+
+    p   += n;
+    len -= n;
+  }
+}
+
+CArgFingerprint
+CArgHasher::
+result() const
+{
+  uint64_t h1 = h1_ ^ len_;
+  uint64_t h2 = h2_ ^ len_;
+
+  h1 += h2; h2 += h1;
+
+  h1 = fmix64(h1);
+  h2 = fmix64(h2);
+
+  h1 += h2; h2 += h1;
+
+  CArgFingerprint fp;
+
+  fp.lo = h1;
+  fp.hi = h2;
+
+  return fp;
+}
+
+std::string
+CArgFingerprint::
+toString() const
+{
+  char buffer[33];
+
+  snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+           static_cast<unsigned long long>(hi), static_cast<unsigned long long>(lo));
+
+  return buffer;
+}
+
+//------
+
 CArgs::
 CArgs(const std::string &def)
 {
@@ -114,11 +317,28 @@ CArgs(const std::string &def)
 
 void
 CArgs::
-setFormat(const std::string &def)
+setFormat(const std::string &format)
 {
-  def_ = def;
+  // option strings are views of the format string (or in the string pool)
+  // so remove old options first
+  for (auto &arg : args_)
+    delete arg;
+
+  args_   .clear();
+  actions_.clear();
 
-  args_.clear();
+  matchHashes_.clear();
+  matchInfo_  .clear();
+
+  fingerprint_ = CArgFingerprint();
+
+  argFingerprints_.clear();
+
+  pool_.clear();
+
+  def_ = format;
+
+  const std::string &def = def_;
 
   uint i = 0;
 
@@ -153,15 +373,21 @@ setFormat(const std::string &def)
     while (i < def.size() && (isalnum(def[i]) || def[i] == '_'))
       ++i;
 
-    std::string name = def.substr(j, i - j);
+    std::string_view name = formatString(j, i - j);
 
     //------
 
-    CArgType   type     = CARG_TYPE_BOOLEAN;
-    int        count    = 1;
-    int        flags    = CARG_FLAG_NONE;
-    bool       attached = false;
-    StringList choices;
+    CArgType    type        = CARG_TYPE_BOOLEAN;
+    int         count       = 1;
+    int         flags       = CARG_FLAG_NONE;
+    bool        attached    = false;
+    CArgChoice::ChoiceList choices;
+    bool        has_range   = false;
+    std::string minstr, maxstr;
+    bool        has_pattern = false;
+    std::string pattern;
+    CArgCustomTypeP customType;
+    int         checks      = CARG_PATH_CHECK_NONE;
 
     //------
 
@@ -178,9 +404,32 @@ setFormat(const std::string &def)
         type = CARG_TYPE_STRING;
       else if (def[i] == 'c' || def[i] == 'C')
         type = CARG_TYPE_CHOICE;
+      else if (def[i] == 'b' || def[i] == 'B')
+        type = CARG_TYPE_SIZE;
+      else if (def[i] == 't' || def[i] == 'T')
+        type = CARG_TYPE_DURATION;
+      else if (def[i] == 'q' || def[i] == 'Q')
+        type = CARG_TYPE_RATE;
+      else if (def[i] == 'p' || def[i] == 'P')
+        type = CARG_TYPE_PATH;
+      else if (isalpha(def[i])) {
+        customType = lookupType(char(tolower(def[i])));
+
+        if (! customType) {
+          CTHROW(std::string("Invalid Type ") + def[i]);
+          return;
+        }
+
+        type = CARG_TYPE_CUSTOM;
+
+        if (isupper(def[i]))
+          attached = true;
+      }
 
       if (def[i] == 'I' || def[i] == 'R' ||
-          def[i] == 'S' || def[i] == 'C')
+          def[i] == 'S' || def[i] == 'C' ||
+          def[i] == 'B' || def[i] == 'T' || def[i] == 'Q' ||
+          def[i] == 'P')
         attached = true;
 
       if (type == CARG_TYPE_CHOICE) {
@@ -198,18 +447,108 @@ setFormat(const std::string &def)
         while (i < def.size() && def[i] != ']')
           ++i;
 
-        std::string opts = def.substr(jj, i - jj);
+        // space or comma separated choices (views of format string)
+        for (auto k = jj; k < i; ) {
+          while (k < i && (def[k] == ' ' || def[k] == ','))
+            ++k;
 
-        std::vector<std::string> words;
+          auto kk = k;
+
+          while (k < i && def[k] != ' ' && def[k] != ',')
+            ++k;
+
+          if (k > kk)
+            choices.push_back(formatString(kk, k - kk));
+        }
+      }
+      else if (type == CARG_TYPE_PATH && i + 1 < def.size() && def[i + 1] == '[') {
+        i += 2;
+
+        auto jj = i;
+
+        while (i < def.size() && def[i] != ']')
+          ++i;
 
-        CStrUtil::addFields(opts, words, " ,");
+        std::vector<std::string> words;
 
-        for (uint k = 0; k < words.size(); ++k)
-          choices.push_back(words[k]);
+        CStrUtil::addFields(def.substr(jj, i - jj), words, " ,");
+
+        for (const auto &word : words) {
+          if      (word == "exists"  ) checks |= CARG_PATH_CHECK_EXISTS;
+          else if (word == "file"    ) checks |= CARG_PATH_CHECK_FILE;
+          else if (word == "dir"     ) checks |= CARG_PATH_CHECK_DIR;
+          else if (word == "readable") checks |= CARG_PATH_CHECK_READABLE;
+          else if (word == "writable") checks |= CARG_PATH_CHECK_WRITABLE;
+          else {
+            CTHROW(std::string("Invalid Path Check ") + word);
+            return;
+          }
+        }
       }
 
       ++i;
 
+      if      (i < def.size() && def[i] == '{') {
+        if (type != CARG_TYPE_INTEGER && type != CARG_TYPE_REAL) {
+          CTHROW("Range only supported for -i/I/r/R");
+          return;
+        }
+
+        ++i;
+
+        auto jj = i;
+
+        while (i < def.size() && def[i] != '}')
+          ++i;
+
+        if (i >= def.size()) {
+          CTHROW("Missing } for Range");
+          return;
+        }
+
+        std::string range = def.substr(jj, i - jj);
+
+        auto pos = range.find(',');
+
+        if (pos == std::string::npos) {
+          CTHROW(std::string("Invalid Range ") + range);
+          return;
+        }
+
+        minstr = range.substr(0, pos);
+        maxstr = range.substr(pos + 1);
+
+        has_range = true;
+
+        ++i;
+      }
+      else if (i < def.size() && def[i] == '/') {
+        if (type != CARG_TYPE_STRING) {
+          CTHROW("Pattern only supported for -s/S");
+          return;
+        }
+
+        ++i;
+
+        while (i < def.size() && def[i] != '/') {
+          if (def[i] == '\\' && i + 1 < def.size() && def[i + 1] == '/')
+            ++i;
+
+          pattern += def[i];
+
+          ++i;
+        }
+
+        if (i >= def.size()) {
+          CTHROW("Missing / for Pattern");
+          return;
+        }
+
+        has_pattern = true;
+
+        ++i;
+      }
+
       if (isdigit(def[i])) {
         auto jj = i;
 
@@ -248,7 +587,7 @@ setFormat(const std::string &def)
 
     //------
 
-    std::string defval = "";
+    std::string_view defval;
 
     if (i < def.size() && def[i] == '=') {
       ++i;
@@ -262,12 +601,18 @@ setFormat(const std::string &def)
         ++i;
       }
 
-      defval = def.substr(jj, i - jj);
+      defval = formatString(jj, i - jj);
     }
 
+    // numeric defaults are converted from a (null terminated) copy
+    std::string defstr;
+
+    if (type != CARG_TYPE_STRING && type != CARG_TYPE_PATH && type != CARG_TYPE_CUSTOM)
+      defstr = defval;
+
     //------
 
-    std::string desc = "";
+    std::string_view desc;
 
     j = i;
 
@@ -288,7 +633,7 @@ setFormat(const std::string &def)
         ++i;
       }
 
-      desc = def.substr(jj, i - jj);
+      desc = formatString(jj, i - jj);
 
       if (i < def.size() && def[i] == ')')
         ++i;
@@ -306,13 +651,13 @@ setFormat(const std::string &def)
     if      (type == CARG_TYPE_BOOLEAN) {
       bool defval1 = false;
 
-      if (defval != "") {
-        if (! CStrUtil::isBool(defval)) {
+      if (defstr != "") {
+        if (! CStrUtil::isBool(defstr)) {
           CTHROW("Invalid Boolean");
           return;
         }
 
-        defval1 = CStrUtil::toBool(defval);
+        defval1 = CStrUtil::toBool(defstr);
       }
 
       if (count == 1)
@@ -325,17 +670,46 @@ setFormat(const std::string &def)
     else if (type == CARG_TYPE_INTEGER) {
       long defval1 = 0;
 
-      if (defval != "") {
-        if (! CStrUtil::isInteger(defval)) {
+      if (defstr != "") {
+        if (! CStrUtil::isInteger(defstr)) {
           CTHROW("Invalid Integer");
           return;
         }
 
-        defval1 = CStrUtil::toInteger(defval);
+        defval1 = CStrUtil::toInteger(defstr);
       }
 
-      if (count == 1)
-        arg = new CArgInteger(name, flags, defval1, attached, desc);
+      long min = std::numeric_limits<long>::min();
+      long max = std::numeric_limits<long>::max();
+
+      if (has_range) {
+        if ((minstr != "" && ! CStrUtil::isInteger(minstr)) ||
+            (maxstr != "" && ! CStrUtil::isInteger(maxstr))) {
+          CTHROW("Invalid Integer for Range");
+          return;
+        }
+
+        if (minstr != "") min = CStrUtil::toInteger(minstr);
+        if (maxstr != "") max = CStrUtil::toInteger(maxstr);
+
+        if (min > max) {
+          CTHROW("Invalid Range");
+          return;
+        }
+
+        if (defstr != "" && (defval1 < min || defval1 > max)) {
+          CTHROW("Default out of Range");
+          return;
+        }
+      }
+
+      if (count == 1) {
+        auto *iarg = new CArgInteger(name, flags, defval1, attached, desc);
+
+        iarg->setRange(min, max);
+
+        arg = iarg;
+      }
       else {
         CTHROW("Multiple values not supported");
         return;
@@ -344,27 +718,69 @@ setFormat(const std::string &def)
     else if (type == CARG_TYPE_REAL) {
       double defval1 = 0;
 
-      if (defval != "") {
-        if (! CStrUtil::isReal(defval)) {
+      if (defstr != "") {
+        if (! CStrUtil::isReal(defstr)) {
           CTHROW("Invalid Real");
           return;
         }
 
-        defval1 = CStrUtil::toReal(defval);
+        defval1 = CStrUtil::toReal(defstr);
       }
 
-      if (count == 1)
-        arg = new CArgReal(name, flags, defval1, attached, desc);
+      double min = -std::numeric_limits<double>::max();
+      double max =  std::numeric_limits<double>::max();
+
+      if (has_range) {
+        if ((minstr != "" && ! CStrUtil::isReal(minstr)) ||
+            (maxstr != "" && ! CStrUtil::isReal(maxstr))) {
+          CTHROW("Invalid Real for Range");
+          return;
+        }
+
+        if (minstr != "") min = CStrUtil::toReal(minstr);
+        if (maxstr != "") max = CStrUtil::toReal(maxstr);
+
+        if (min > max) {
+          CTHROW("Invalid Range");
+          return;
+        }
+
+        if (defstr != "" && (defval1 < min || defval1 > max)) {
+          CTHROW("Default out of Range");
+          return;
+        }
+      }
+
+      if (count == 1) {
+        auto *rarg = new CArgReal(name, flags, defval1, attached, desc);
+
+        rarg->setRange(min, max);
+
+        arg = rarg;
+      }
       else {
         CTHROW("Multiple values not supported");
         return;
       }
     }
     else if (type == CARG_TYPE_STRING) {
-      if      (flags & CARG_FLAG_MULTIPLE)
-        arg = new CArgStringList(name, flags, defval, attached, desc);
-      else if (count == 1)
-        arg = new CArgString(name, flags, defval, attached, desc);
+      if      (flags & CARG_FLAG_MULTIPLE) {
+        // not leaked if pattern is invalid
+        std::unique_ptr<CArgStringList> sarg(new CArgStringList(name, flags, defval, attached, desc));
+
+        if (has_pattern)
+          sarg->setPattern(pattern);
+
+        arg = sarg.release();
+      }
+      else if (count == 1) {
+        std::unique_ptr<CArgString> sarg(new CArgString(name, flags, defval, attached, desc));
+
+        if (has_pattern)
+          sarg->setPattern(pattern);
+
+        arg = sarg.release();
+      }
       else {
         CTHROW("Multiple values not supported");
         return;
@@ -373,13 +789,13 @@ setFormat(const std::string &def)
     else if (type == CARG_TYPE_CHOICE) {
       long defval1 = 0;
 
-      if (defval != "") {
-        if (! CStrUtil::isInteger(defval)) {
+      if (defstr != "") {
+        if (! CStrUtil::isInteger(defstr)) {
           CTHROW("Invalid Integer");
           return;
         }
 
-        defval1 = CStrUtil::toInteger(defval);
+        defval1 = CStrUtil::toInteger(defstr);
       }
 
       if (count == 1)
@@ -389,6 +805,67 @@ setFormat(const std::string &def)
         return;
       }
     }
+    else if (type == CARG_TYPE_SIZE) {
+      long defval1 = 0;
+
+      if (defstr != "" && ! CArgSize::parseValue(defstr.c_str(), defval1)) {
+        CTHROW("Invalid Size");
+        return;
+      }
+
+      if (count == 1)
+        arg = new CArgSize(name, flags, defval1, attached, desc);
+      else {
+        CTHROW("Multiple values not supported");
+        return;
+      }
+    }
+    else if (type == CARG_TYPE_DURATION) {
+      long defval1 = 0;
+
+      if (defstr != "" && ! CArgDuration::parseValue(defstr.c_str(), defval1)) {
+        CTHROW("Invalid Duration");
+        return;
+      }
+
+      if (count == 1)
+        arg = new CArgDuration(name, flags, defval1, attached, desc);
+      else {
+        CTHROW("Multiple values not supported");
+        return;
+      }
+    }
+    else if (type == CARG_TYPE_RATE) {
+      long defcount = 0, defperiod = 1000000000L;
+
+      if (defstr != "" && ! CArgRate::parseValue(defstr.c_str(), defcount, defperiod)) {
+        CTHROW("Invalid Rate");
+        return;
+      }
+
+      if (count == 1)
+        arg = new CArgRate(name, flags, defcount, defperiod, attached, desc);
+      else {
+        CTHROW("Multiple values not supported");
+        return;
+      }
+    }
+    else if (type == CARG_TYPE_PATH) {
+      if (count == 1)
+        arg = new CArgPath(name, flags, checks, defval, attached, desc);
+      else {
+        CTHROW("Multiple values not supported");
+        return;
+      }
+    }
+    else if (type == CARG_TYPE_CUSTOM) {
+      if (count == 1)
+        arg = new CArgCustom(name, flags, customType, defval, attached, desc);
+      else {
+        CTHROW("Multiple values not supported");
+        return;
+      }
+    }
 
     args_.push_back(arg);
   }
@@ -451,56 +928,129 @@ parse(int *argc, char **argv)
   return parse1(argc, argv, true);
 }
 
+// parse options from a command string (shell quoting rules, see CArgsTokenizer).
+// The words are kept until the next parseString.
 bool
 CArgs::
-parse1(int *argc, char **argv, bool update)
+parseString(const std::string &str)
 {
-  skip_remaining_ = false;
-
-  std::vector<char *> new_argv;
+  if (! tokenizer_)
+    tokenizer_ = std::make_unique<CArgsTokenizer>();
 
-  int i = 0;
+  if (! tokenizer_->tokenize(str, "")) {
+    errors_     .clear();
+    positionals_.clear();
 
-  if (i < *argc) {
-    if (update)
-      new_argv.push_back(argv[i]);
+    addError(tokenizer_->getError());
 
-    ++i;
+    return reportErrors();
   }
 
-  while (i < *argc) {
-    if (argv[i][0] != '-' || skip_remaining_) {
-      if (update)
-        new_argv.push_back(argv[i]);
+  return parse(tokenizer_->argc(), tokenizer_->argv());
+}
 
-      ++i;
+bool
+CArgs::
+parse1(int *argc, char **argv, bool update)
+{
+  errors_     .clear();
+  positionals_.clear();
 
-      continue;
-    }
+  if (! responseFiles_ || ! hasResponseFile(*argc, argv))
+    return parseArgv(argc, argv, update);
 
-    if (strcmp(argv[i], "--") == 0) {
-      ++i;
+  // parse expanded response files (strings are kept until next parse)
+  responseArgs_.clear();
 
-      skip_remaining_ = true;
+  for (int i = 0; i < *argc; ++i)
+    responseArgs_.push_back(argv[i]);
 
-      continue;
-    }
+  expandResponseFiles(responseArgs_);
 
-    if (strcmp(argv[i], "--help") == 0) {
-      usage(argv[0]);
+  std::vector<char *> argv1;
 
-      ++i;
+  for (auto &arg : responseArgs_)
+    argv1.push_back(const_cast<char *>(arg.c_str()));
 
-      help_ = true;
+  argv1.push_back(nullptr);
 
-      continue;
+  int argc1 = int(responseArgs_.size());
+
+  bool rc = parseArgv(&argc1, &argv1[0], update);
+
+  if (update) {
+    if (argc1 > *argc) {
+      std::cerr << "Error: Too many arguments from response files to update argv "
+                   "(use getPositionals)\n";
+      return false;
     }
 
-    auto parg = args_.begin();
+    for (int i = 0; i < argc1; ++i)
+      argv[i] = argv1[size_t(i)];
 
-    for ( ; parg != args_.end(); ++parg)
-      if ((*parg)->optionCmp(argv[i]))
-        break;
+    if (argc1 < *argc)
+      argv[argc1] = nullptr;
+
+    *argc = argc1;
+  }
+
+  return rc;
+}
+
+bool
+CArgs::
+parseArgv(int *argc, char **argv, bool update)
+{
+  skip_remaining_ = false;
+
+  updateMatchIndex();
+
+  updateFingerprints();
+
+  std::vector<char *> new_argv;
+
+  int i = 0;
+
+  if (i < *argc) {
+    if (update)
+      new_argv.push_back(argv[i]);
+
+    ++i;
+  }
+
+  while (i < *argc) {
+    if (argv[i][0] != '-' || skip_remaining_) {
+      positionals_.push_back(argv[i]);
+
+      if (update)
+        new_argv.push_back(argv[i]);
+
+      ++i;
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--") == 0) {
+      ++i;
+
+      skip_remaining_ = true;
+
+      continue;
+    }
+
+    if (strcmp(argv[i], "--help") == 0) {
+      usage(argv[0]);
+
+      ++i;
+
+      help_ = true;
+
+      continue;
+    }
+
+    int ind = matchOption(argv[i], strlen(argv[i]));
+
+    auto parg = (ind >= 0 ? args_.begin() + ind : args_.end());
 
     if (parg == args_.end()) {
       bool single_letter_flag = false;
@@ -509,7 +1059,7 @@ parse1(int *argc, char **argv, bool update)
 
       for ( ; parg != args_.end(); ++parg) {
         if ((*parg)->getType() == CARG_TYPE_BOOLEAN &&
-            (*parg)->getName().size() == 2) {
+            (*parg)->getNameView().size() == 2) {
           single_letter_flag = true;
           break;
         }
@@ -535,10 +1085,10 @@ parse1(int *argc, char **argv, bool update)
 
         for ( ; parg != args_.end(); ++parg) {
           if ((*parg)->getType() != CARG_TYPE_BOOLEAN ||
-              (*parg)->getName().size() != 2)
+              (*parg)->getNameView().size() != 2)
             continue;
 
-          if (argv[i][j] == (*parg)->getName()[1]) {
+          if (argv[i][j] == (*parg)->getNameView()[1]) {
             found = true;
             break;
           }
@@ -564,12 +1114,16 @@ parse1(int *argc, char **argv, bool update)
 
         for ( ; parg != args_.end(); ++parg) {
           if ((*parg)->getType() != CARG_TYPE_BOOLEAN ||
-              (*parg)->getName().size() != 2)
+              (*parg)->getNameView().size() != 2)
             continue;
 
-          if (argv[i][j] == (*parg)->getName()[1]) {
+          if (argv[i][j] == (*parg)->getNameView()[1]) {
             (*parg)->setValue("", nullptr, 0);
 
+            updateFingerprint(size_t(parg - args_.begin()));
+
+            doAction(size_t(parg - args_.begin()));
+
             if (update) {
               if ((*parg)->getSkip()) {
                 char *argv1 = new char [3];
@@ -591,7 +1145,7 @@ parse1(int *argc, char **argv, bool update)
       int num_args = (*parg)->getNumArgs();
 
       if (i + num_args >= *argc) {
-        std::cerr << "Error: Missing Value for " << argv[i] << "\n";
+        addError(std::string("Missing Value for ") + argv[i]);
         break;
       }
 
@@ -599,8 +1153,21 @@ parse1(int *argc, char **argv, bool update)
 
       bool flag = (*parg)->setValue(argv[i - 1], const_cast<const char **>(&argv[i]), *argc - i);
 
-      if (! flag)
-        std::cerr << "Error: Invalid Value " << argv[i] << " for " << argv[i - 1] << "\n";
+      updateFingerprint(size_t(parg - args_.begin()));
+
+      if (! flag) {
+        // attached value is rest of option argument
+        std::string opt   = argv[i - 1];
+        std::string value = (num_args > 0 ? argv[i] : opt.substr((*parg)->getNameView().size()));
+
+        if (num_args == 0)
+          opt.resize((*parg)->getNameView().size());
+
+        addError("Invalid Value " + value + " for " + opt +
+                 ((*parg)->getError() != "" ? " (" + (*parg)->getError() + ")" : ""));
+      }
+      else
+        doAction(size_t(parg - args_.begin()));
 
       if (update) {
         if ((*parg)->getSkip()) {
@@ -622,10 +1189,17 @@ parse1(int *argc, char **argv, bool update)
       argv[ii] = new_argv[ii];
   }
 
-  if (! checkRequired())
+  if (globPositionals_)
+    expandPositionals();
+
+  checkPaths();
+
+  bool rc = reportErrors();
+
+  if (requiredChecked_ && ! checkRequired())
     return false;
 
-  return true;
+  return rc;
 }
 
 bool
@@ -648,6 +1222,32 @@ bool
 CArgs::
 parse1(std::vector<std::string> &args, bool update)
 {
+  errors_     .clear();
+  positionals_.clear();
+
+  if (! responseFiles_)
+    return parseArgs(args, update);
+
+  std::vector<std::string> args1 = args;
+
+  expandResponseFiles(args1);
+
+  bool rc = parseArgs(args1, update);
+
+  if (update)
+    args = args1;
+
+  return rc;
+}
+
+bool
+CArgs::
+parseArgs(std::vector<std::string> &args, bool update)
+{
+  updateMatchIndex();
+
+  updateFingerprints();
+
   auto num_args = args.size();
 
   std::vector<std::string> new_args;
@@ -665,6 +1265,8 @@ parse1(std::vector<std::string> &args, bool update)
     auto len = args[i].size();
 
     if (len == 0 || args[i][0] != '-') {
+      positionals_.push_back(args[i]);
+
       if (update)
         new_args.push_back(args[i]);
 
@@ -683,11 +1285,9 @@ parse1(std::vector<std::string> &args, bool update)
       continue;
     }
 
-    auto parg = args_.begin();
+    int ind = matchOption(args[i].c_str(), args[i].size());
 
-    for ( ; parg != args_.end(); ++parg)
-      if ((*parg)->optionCmp(args[i]))
-        break;
+    auto parg = (ind >= 0 ? args_.begin() + ind : args_.end());
 
     if (parg == args_.end()) {
       bool single_letter_flag = false;
@@ -696,7 +1296,7 @@ parse1(std::vector<std::string> &args, bool update)
 
       for ( ; parg != args_.end(); ++parg) {
         if ((*parg)->getType() == CARG_TYPE_BOOLEAN &&
-            (*parg)->getName().size() == 2) {
+            (*parg)->getNameView().size() == 2) {
           single_letter_flag = true;
           break;
         }
@@ -722,10 +1322,10 @@ parse1(std::vector<std::string> &args, bool update)
 
         for ( ; parg != args_.end(); ++parg) {
           if ((*parg)->getType() != CARG_TYPE_BOOLEAN ||
-              (*parg)->getName().size() != 2)
+              (*parg)->getNameView().size() != 2)
             continue;
 
-          if (args[i][j] == (*parg)->getName()[1]) {
+          if (args[i][j] == (*parg)->getNameView()[1]) {
             found = true;
             break;
           }
@@ -752,12 +1352,16 @@ parse1(std::vector<std::string> &args, bool update)
 
         for ( ; parg != args_.end(); ++parg) {
           if ((*parg)->getType() != CARG_TYPE_BOOLEAN ||
-              (*parg)->getName().size() != 2)
+              (*parg)->getNameView().size() != 2)
             continue;
 
-          if (args[i][j] == (*parg)->getName()[1]) {
+          if (args[i][j] == (*parg)->getNameView()[1]) {
             (*parg)->setValue("", nullptr, 0);
 
+            updateFingerprint(size_t(parg - args_.begin()));
+
+            doAction(size_t(parg - args_.begin()));
+
             if (update) {
               if ((*parg)->getSkip()) {
                 std::string args1 = "-x";
@@ -777,7 +1381,7 @@ parse1(std::vector<std::string> &args, bool update)
       auto num_args1 = uint((*parg)->getNumArgs());
 
       if (i + num_args1 >= num_args) {
-        std::cerr << "Error: Missing Value for " << args[i] << "\n";
+        addError("Missing Value for " + args[i]);
         break;
       }
 
@@ -790,8 +1394,21 @@ parse1(std::vector<std::string> &args, bool update)
 
       bool flag = (*parg)->setValue(args[i - 1], args1);
 
-      if (! flag)
-        std::cerr << "Error: Invalid Value " << args[i] << " for " << args[i - 1] << "\n";
+      updateFingerprint(size_t(parg - args_.begin()));
+
+      if (! flag) {
+        // attached value is rest of option argument
+        std::string opt   = args[i - 1];
+        std::string value = (num_args1 > 0 ? args[i] : opt.substr((*parg)->getNameView().size()));
+
+        if (num_args1 == 0)
+          opt.resize((*parg)->getNameView().size());
+
+        addError("Invalid Value " + value + " for " + opt +
+                 ((*parg)->getError() != "" ? " (" + (*parg)->getError() + ")" : ""));
+      }
+      else
+        doAction(size_t(parg - args_.begin()));
 
       if (update) {
         if ((*parg)->getSkip()) {
@@ -809,10 +1426,17 @@ parse1(std::vector<std::string> &args, bool update)
   if (update)
     args = new_args;
 
-  if (! checkRequired())
+  if (globPositionals_)
+    expandPositionals();
+
+  checkPaths();
+
+  bool rc = reportErrors();
+
+  if (requiredChecked_ && ! checkRequired())
     return false;
 
-  return true;
+  return rc;
 }
 
 bool
@@ -997,6 +1621,96 @@ getChoiceArg(int i) const
   return arg1->getValue();
 }
 
+long
+CArgs::
+getSizeArg(const std::string &name) const
+{
+  CArgSize *arg = lookupSizeArg(name);
+
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Size"));
+    return 0;
+  }
+
+  return arg->getValue();
+}
+
+long
+CArgs::
+getSizeArg(int i) const
+{
+  CArg *arg = getArg(i);
+
+  CArgSize *arg1 = dynamic_cast<CArgSize *>(arg);
+
+  if (! arg1) {
+    CTHROW(std::string("Option ") + arg->getName() + std::string(" is not Size"));
+    return 0;
+  }
+
+  return arg1->getValue();
+}
+
+long
+CArgs::
+getDurationArg(const std::string &name) const
+{
+  CArgDuration *arg = lookupDurationArg(name);
+
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Duration"));
+    return 0;
+  }
+
+  return arg->getValue();
+}
+
+long
+CArgs::
+getDurationArg(int i) const
+{
+  CArg *arg = getArg(i);
+
+  CArgDuration *arg1 = dynamic_cast<CArgDuration *>(arg);
+
+  if (! arg1) {
+    CTHROW(std::string("Option ") + arg->getName() + std::string(" is not Duration"));
+    return 0;
+  }
+
+  return arg1->getValue();
+}
+
+double
+CArgs::
+getRateArg(const std::string &name) const
+{
+  CArgRate *arg = lookupRateArg(name);
+
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Rate"));
+    return 0.0;
+  }
+
+  return arg->getValue();
+}
+
+double
+CArgs::
+getRateArg(int i) const
+{
+  CArg *arg = getArg(i);
+
+  CArgRate *arg1 = dynamic_cast<CArgRate *>(arg);
+
+  if (! arg1) {
+    CTHROW(std::string("Option ") + arg->getName() + std::string(" is not Rate"));
+    return 0.0;
+  }
+
+  return arg1->getValue();
+}
+
 bool
 CArgs::
 isBooleanArg(const std::string &name) const
@@ -1213,6 +1927,27 @@ isChoiceArg(int i) const
   return true;
 }
 
+bool
+CArgs::
+isSizeArg(const std::string &name) const
+{
+  return (lookupSizeArg(name) != nullptr);
+}
+
+bool
+CArgs::
+isDurationArg(const std::string &name) const
+{
+  return (lookupDurationArg(name) != nullptr);
+}
+
+bool
+CArgs::
+isRateArg(const std::string &name) const
+{
+  return (lookupRateArg(name) != nullptr);
+}
+
 CArgBoolean *
 CArgs::
 lookupBooleanArg(const std::string &name) const
@@ -1315,349 +2050,1936 @@ lookupChoiceArg(const std::string &name) const
   return arg1;
 }
 
-CArg *
+void
 CArgs::
-lookupArg(const std::string &name) const
+addType(const CArgCustomTypeP &type)
 {
-  for (auto &arg : args_)
-    if (arg->nameCmp(name))
-      return arg;
+  // type letters of setFormat
+  static const char *builtin = "firscbtqp";
 
-  return nullptr;
+  if (! islower(type->letter) || strchr(builtin, type->letter)) {
+    CTHROW(std::string("Invalid Type Letter ") + type->letter);
+    return;
+  }
+
+  if (lookupType(type->letter) || lookupType(type->name)) {
+    CTHROW(std::string("Duplicate Type ") + type->name);
+    return;
+  }
+
+  types_.push_back(type);
 }
 
-void
+CArgCustomTypeP
 CArgs::
-resetSet()
+lookupType(char letter) const
 {
-  for (auto &arg : args_)
-    arg->setSet(false);
+  for (const auto &type : types_)
+    if (type->letter == letter)
+      return type;
+
+  return CArgCustomTypeP();
 }
 
-bool
+CArgCustomTypeP
 CArgs::
-checkRequired()
+lookupType(const std::string &name) const
 {
-  bool all_found = true;
+  for (const auto &type : types_)
+    if (type->name == name)
+      return type;
 
-  for (auto &arg : args_) {
-    if (arg->getRequired() && ! arg->getSet()) {
-      std::cerr << "Required argument " << arg->getName() << " not supplied\n";
-      all_found = false;
-    }
+  return CArgCustomTypeP();
+}
+
+void
+CArgs::
+addCustomArg(const std::string &name, const std::string &typeName, int flags,
+             const std::string &defval, bool attached, const std::string &desc)
+{
+  CArgCustomTypeP customType = lookupType(typeName);
+
+  if (! customType) {
+    CTHROW(std::string("Invalid Type ") + typeName);
+    return;
   }
 
-  return all_found;
+  args_.push_back(new CArgCustom(intern(name), flags, customType, defval, attached, intern(desc)));
 }
 
 bool
 CArgs::
-checkOption(const char *arg, std::string &opt)
+isCustomArg(const std::string &name) const
 {
-  opt = "";
+  return (dynamic_cast<CArgCustom *>(lookupArg(name)) != nullptr);
+}
 
-  if (strcmp(arg, "--") == 0) {
-    skip_remaining_ = true;
+const CArgCustom *
+CArgs::
+lookupCustomArg(const std::string &name, const std::type_info &ti) const
+{
+  CArgCustom *arg = dynamic_cast<CArgCustom *>(lookupArg(name));
 
-    return true;
+  if (! arg || *arg->getCustomType().typeInfo != ti) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Custom type"));
+    return nullptr;
   }
 
-  if (skip_remaining_ || arg[0] != '-')
-    return false;
+  return arg;
+}
 
-  opt = &arg[1];
+const CArgCustom *
+CArgs::
+lookupCustomArg(int i, const std::type_info &ti) const
+{
+  CArg *arg = getArg(i);
 
-  return true;
+  CArgCustom *arg1 = dynamic_cast<CArgCustom *>(arg);
+
+  if (! arg1 || *arg1->getCustomType().typeInfo != ti) {
+    CTHROW(std::string("Option ") + arg->getName() + std::string(" is not Custom type"));
+    return nullptr;
+  }
+
+  return arg1;
 }
 
-void
+bool
 CArgs::
-unhandledOpt(const std::string &opt)
+isPathArg(const std::string &name) const
 {
-  if (opt != "")
-    std::cerr << "Unhandled option: -" << opt << "\n";
+  return (lookupPathArg(name) != nullptr);
 }
 
-void
+std::string
 CArgs::
-usage(const std::string &cmd) const
+getPathArg(const std::string &name) const
 {
-  uint max_name_len = 0;
-
-  std::cerr << cmd << " ";
+  CArgPath *arg = lookupPathArg(name);
 
-  for (auto &arg : args_) {
-    if (! arg->getRequired())
-      std::cerr << "[";
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Path"));
+    return "";
+  }
 
-    std::cerr << arg->getName();
+  return std::string(arg->getValue());
+}
 
-    max_name_len = std::max(uint(arg->getName().size()), max_name_len);
-
-    CArgType type = arg->getType();
+CArgs::StringList
+CArgs::
+getPathListArg(const std::string &name) const
+{
+  CArgPath *arg = lookupPathArg(name);
 
-    if (type != CARG_TYPE_BOOLEAN && ! arg->getAttached())
-      std::cerr << " ";
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Path"));
+    return StringList();
+  }
 
-    if      (type == CARG_TYPE_INTEGER)
-      std::cerr << "<integer>";
-    else if (type == CARG_TYPE_REAL)
-      std::cerr << "<real>";
-    else if (type == CARG_TYPE_STRING)
-      std::cerr << "<string>";
-    else if (type == CARG_TYPE_CHOICE)
-      std::cerr << "<choice>";
+  return arg->getValues();
+}
 
-    if (! arg->getRequired())
-      std::cerr << "]";
+void
+CArgs::
+setPathChecks(const std::string &name, int checks)
+{
+  CArgPath *arg = lookupPathArg(name);
 
-    std::cerr << " ";
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Path"));
+    return;
   }
 
-  std::cerr << "\n";
+  arg->setChecks(checks);
+}
 
-  for (auto &arg : args_) {
-    std::cerr << " ";
+CArgPath *
+CArgs::
+lookupPathArg(const std::string &name) const
+{
+  return dynamic_cast<CArgPath *>(lookupArg(name));
+}
 
-    std::cerr << arg->getName();
+CArgSize *
+CArgs::
+lookupSizeArg(const std::string &name) const
+{
+  return dynamic_cast<CArgSize *>(lookupArg(name));
+}
 
-    for (uint i = 0; i < max_name_len - arg->getName().size(); ++i)
-      std::cerr << " ";
+CArgDuration *
+CArgs::
+lookupDurationArg(const std::string &name) const
+{
+  return dynamic_cast<CArgDuration *>(lookupArg(name));
+}
 
-    std::cerr << " : ";
+CArgRate *
+CArgs::
+lookupRateArg(const std::string &name) const
+{
+  return dynamic_cast<CArgRate *>(lookupArg(name));
+}
 
-    std::cerr << arg->getDesc();
+int
+CArgs::
+getArgIndex(const std::string &name) const
+{
+  int num_args = getNumArgs();
 
-    std::cerr << "\n";
-  }
+  for (int i = 0; i < num_args; ++i)
+    if (args_[size_t(i)]->nameCmp(name))
+      return i;
+
+  return -1;
+}
+
+CArg *
+CArgs::
+lookupArg(const std::string &name) const
+{
+  for (auto &arg : args_)
+    if (arg->nameCmp(name))
+      return arg;
+
+  return nullptr;
 }
 
 void
 CArgs::
-print() const
+resetSet()
 {
   for (auto &arg : args_)
-    arg->print();
+    arg->setSet(false);
+
+  // set flags are part of the fingerprint
+  fingerprint_ = CArgFingerprint();
+
+  argFingerprints_.clear();
+
+  updateFingerprints();
 }
 
-//-------
+bool
+CArgs::
+checkRequired()
+{
+  bool all_found = true;
 
-CArg::
-CArg(const std::string &name, CArgType type, int flags, bool attached, const std::string &desc) :
- name_(name), type_(type), flags_(flags), attached_(attached), desc_(desc)
+  for (auto &arg : args_) {
+    if (arg->getRequired() && ! arg->getSet()) {
+      std::cerr << "Required argument " << arg->getNameView() << " not supplied\n";
+      all_found = false;
+    }
+  }
+
+  return all_found;
+}
+
+std::string_view
+CArgs::
+intern(const std::string_view &str)
 {
+  // already in format string
+  if (str.data() >= def_.data() && str.data() + str.size() <= def_.data() + def_.size())
+    return str;
+
+  return pool_.add(str);
 }
 
-bool
-CArg::
-optionCmp(const std::string &opt)
+std::string_view
+CArgs::
+formatString(size_t pos, size_t len)
 {
-  if (! attached_) {
-    if (flags_ & CARG_FLAG_NO_CASE)
-      return (CStrUtil::casecmp(opt, name_) == 0);
-    else
-      return (opt == name_);
+  std::string_view str(&def_[pos], len);
+
+  if (! memchr(str.data(), '\\', len))
+    return str;
+
+  // remove escapes ('\<c>' -> '<c>')
+  std::string str1;
+
+  for (size_t i = 0; i < len; ++i) {
+    if (str[i] == '\\' && i + 1 < len)
+      ++i;
+
+    str1 += str[i];
   }
-  else {
-    if (opt.size() <= name_.size())
-      return false;
 
-    std::string opt1 = opt.substr(0, name_.size());
+  return pool_.add(str1);
+}
+
+// build name match index for options added since last parse
+void
+CArgs::
+updateMatchIndex()
+{
+  for (size_t i = matchHashes_.size(); i < args_.size(); ++i) {
+    const CArg *arg = args_[i];
+
+    std::string_view name = arg->getNameView();
 
-    if (flags_ & CARG_FLAG_NO_CASE)
-      return (CStrUtil::casecmp(opt1, name_) == 0);
-    else
-      return (opt1 == name_);
+    uint32_t info = uint32_t(name.size()) << 2;
+
+    if (arg->getAttached())                   info |= MATCH_ATTACHED;
+    if (arg->getFlags() & CARG_FLAG_NO_CASE) info |= MATCH_NO_CASE;
+
+    matchHashes_.push_back(uint32_t(CArgEnumUtil::hash(name.data(), name.size(), 0)));
+    matchInfo_  .push_back(info);
   }
 }
 
-bool
-CArg::
-nameCmp(const std::string &name)
+// add fingerprints (and their sum) of options added since last parse
+void
+CArgs::
+updateFingerprints()
 {
-  if (flags_ & CARG_FLAG_NO_CASE)
-    return (CStrUtil::casecmp(name, name_) == 0);
-  else
-    return (name == name_);
+  for (size_t i = argFingerprints_.size(); i < args_.size(); ++i) {
+    CArgFingerprint fp = getArgFingerprint(int(i));
+
+    fingerprint_.lo += fp.lo;
+    fingerprint_.hi += fp.hi;
+
+    argFingerprints_.push_back(fp);
+  }
 }
 
-int
-CArg::
-getNumArgs() const
+void
+CArgs::
+updateFingerprint(size_t id)
 {
-  if (attached_)
-    return 0;
-  else
-    return getNumArgs1();
+  if (id >= argFingerprints_.size())
+    return;
+
+  CArgFingerprint &old = argFingerprints_[id];
+  CArgFingerprint  fp  = getArgFingerprint(int(id));
+
+  fingerprint_.lo += fp.lo - old.lo;
+  fingerprint_.hi += fp.hi - old.hi;
+
+  old = fp;
 }
 
-bool
-CArg::
-setValue(const char *opt, const char **args, int num_args)
+CArgFingerprint
+CArgs::
+getArgFingerprint(int id) const
 {
-  if (! attached_)
-    set_ = setValue1(args, num_args);
-  else {
-    char *arg0 = strndup_m(&opt[name_.size()], strlen(opt) - name_.size());
+  const CArg *arg = args_[size_t(id)];
 
-    char **args1 = new char * [uint(num_args + 1)];
+  CArgHasher hasher(static_cast<uint64_t>(id));
 
-    args1[0] = arg0;
+  hasher.add(uint8_t(arg->getType()));
+  hasher.add(uint8_t(arg->getSet()));
 
-    for (int i = 1; i <= num_args; i++)
-      args1[i] = const_cast<char *>(args[i - 1]);
+  arg->hashValue(hasher);
 
-    set_ = setValue1(const_cast<const char **>(args1), num_args + 1);
+  return hasher.result();
+}
 
-    delete [] args1;
+// Sum of option fingerprints (modulo 2^64 per lane) so an option's contribution
+// can be replaced in O(1) when its value changes and the result does not
+// depend on the order options were set in.
+CArgFingerprint
+CArgs::
+getFingerprint() const
+{
+  CArgFingerprint fingerprint = fingerprint_;
 
-    free(arg0);
+  // options added since last parse
+  for (size_t i = argFingerprints_.size(); i < args_.size(); ++i) {
+    CArgFingerprint fp = getArgFingerprint(int(i));
+
+    fingerprint.lo += fp.lo;
+    fingerprint.hi += fp.hi;
   }
 
-  return set_;
+  return fingerprint;
 }
 
-bool
-CArg::
-setValue(const std::string &opt, const std::vector<std::string> &args)
+// index of first option matching command line argument (same as CArg::optionCmp).
+// Unattached options are compared by (case folded) hash and length before the name.
+int
+CArgs::
+matchOption(const char *opt, size_t len) const
 {
-  auto   num_args1 = args.size();
-  char **args1     = new char * [num_args1];
+  uint32_t hash = uint32_t(CArgEnumUtil::hash(opt, len, 0));
 
-  for (uint i = 0; i < num_args1; ++i)
-    args1[i] = const_cast<char *>(args[i].c_str());
+  auto nameCmp = [&](size_t i, size_t n) {
+    const char *name = args_[i]->getNameView().data();
 
-  bool rc = setValue(opt.c_str(), const_cast<const char **>(args1), int(num_args1));
+    if (! (matchInfo_[i] & MATCH_NO_CASE))
+      return (memcmp(opt, name, n) == 0);
 
-  delete [] args1;
+    for (size_t j = 0; j < n; ++j)
+      if (CArgEnumUtil::foldChar(opt[j]) != CArgEnumUtil::foldChar(name[j]))
+        return false;
 
-  return rc;
+    return true;
+  };
+
+  auto num = matchHashes_.size();
+
+  for (size_t i = 0; i < num; ++i) {
+    uint32_t info = matchInfo_[i];
+    size_t   n    = info >> 2;
+
+    if (info & MATCH_ATTACHED) {
+      if (len > n && nameCmp(i, n))
+        return int(i);
+    }
+    else {
+      if (matchHashes_[i] == hash && len == n && nameCmp(i, n))
+        return int(i);
+    }
+  }
+
+  return -1;
 }
 
 bool
-CArg::
-setArg(va_list *vargs)
+CArgs::
+hasResponseFile(int argc, char **argv) const
 {
-  if (flags_ & CARG_FLAG_SKIP)
-    return true;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--") == 0)
+      break;
 
-  return setArg1(vargs);
+    if (argv[i][0] == '@' && argv[i][1] != '\0')
+      return true;
+  }
+
+  return false;
 }
 
+// replace @<file> arguments (before '--') with the arguments read from the file
 void
-CArg::
-print() const
+CArgs::
+expandResponseFiles(StringList &args, int depth)
 {
-  std::cout << "Name     " << name_                           << "\n";
-  std::cout << "Type     " << typeToString(type_)             << "\n";
-  std::cout << "Flags    " << flagsToString(flags_)           << "\n";
-  std::cout << "Attached " << (attached_  ? "true" : "false") << "\n";
+  if (depth > 16) {
+    addError("Response files nested too deeply");
+    return;
+  }
+
+  StringList args1;
+
+  auto num_args = args.size();
+
+  for (uint i = 0; i < num_args; ++i) {
+    const std::string &arg = args[i];
+
+    if (arg == "--") {
+      for ( ; i < num_args; ++i)
+        args1.push_back(args[i]);
+
+      break;
+    }
+
+    if (i == 0 || arg.size() < 2 || arg[0] != '@') {
+      args1.push_back(arg);
+      continue;
+    }
+
+    std::ifstream file(arg.substr(1));
+
+    if (! file) {
+      addError("Cannot read response file " + arg.substr(1));
+      continue;
+    }
+
+    std::stringstream ss;
+
+    ss << file.rdbuf();
+
+    CArgsTokenizer tokenizer;
+
+    if (! tokenizer.tokenize(ss.str(), "")) {
+      addError(tokenizer.getError() + " in response file " + arg.substr(1));
+      continue;
+    }
+
+    StringList fileArgs(tokenizer.argv(), tokenizer.argv() + tokenizer.argc());
+
+    expandResponseFiles(fileArgs, depth + 1);
+
+    for (uint j = 1; j < fileArgs.size(); ++j)
+      args1.push_back(fileArgs[j]);
+  }
+
+  args.swap(args1);
 }
 
-std::string
-CArg::
-typeToString(CArgType type) const
+void
+CArgs::
+expandPositionals()
 {
-  switch (type) {
-    case CARG_TYPE_BOOLEAN:
-      return "Boolean";
-    case CARG_TYPE_INTEGER:
-      return "Integer";
-    case CARG_TYPE_REAL:
-      return "Real";
-    case CARG_TYPE_STRING:
-      return "String";
-    case CARG_TYPE_CHOICE:
-      return "Choice";
-    default:
-      return "????";
+  StringList positionals;
+
+  positionals.swap(positionals_);
+
+  CArgsGlob::expand(positionals, positionals_);
+}
+
+// check all path option values in one batch using a pool of threads (stat
+// of paths on network file systems is latency bound)
+void
+CArgs::
+checkPaths()
+{
+  struct PathCheck {
+    CArgPath   *arg   { nullptr };
+    const char *path  { nullptr };
+    const char *error { nullptr };
+  };
+
+  std::vector<PathCheck> pathChecks;
+
+  for (auto &arg : args_) {
+    if (arg->getType() != CARG_TYPE_PATH || ! arg->getSet())
+      continue;
+
+    auto *parg = static_cast<CArgPath *>(arg);
+
+    if (parg->getChecks() == CARG_PATH_CHECK_NONE)
+      continue;
+
+    for (const auto &value : parg->getValues()) {
+      PathCheck pathCheck;
+
+      pathCheck.arg  = parg;
+      pathCheck.path = value.c_str();
+
+      pathChecks.push_back(pathCheck);
+    }
+  }
+
+  auto num_checks = pathChecks.size();
+
+  if (num_checks == 0)
+    return;
+
+  auto checkPath = [](PathCheck &pathCheck) {
+    int checks = pathCheck.arg->getChecks();
+
+    bool isFile = false, isDir = false;
+
+#ifdef STATX_TYPE
+    struct statx stx;
+
+    if (statx(AT_FDCWD, pathCheck.path, AT_STATX_SYNC_AS_STAT, STATX_TYPE, &stx) != 0) {
+      pathCheck.error = "does not exist";
+      return;
+    }
+
+    isFile = S_ISREG(stx.stx_mode);
+    isDir  = S_ISDIR(stx.stx_mode);
+#else
+    struct stat st;
+
+    if (stat(pathCheck.path, &st) != 0) {
+      pathCheck.error = "does not exist";
+      return;
+    }
+
+    isFile = S_ISREG(st.st_mode);
+    isDir  = S_ISDIR(st.st_mode);
+#endif
+
+    if      ((checks & CARG_PATH_CHECK_FILE) && ! isFile)
+      pathCheck.error = "is not a file";
+    else if ((checks & CARG_PATH_CHECK_DIR) && ! isDir)
+      pathCheck.error = "is not a directory";
+    else if ((checks & CARG_PATH_CHECK_READABLE) &&
+             faccessat(AT_FDCWD, pathCheck.path, R_OK, AT_EACCESS) != 0)
+      pathCheck.error = "is not readable";
+    else if ((checks & CARG_PATH_CHECK_WRITABLE) &&
+             faccessat(AT_FDCWD, pathCheck.path, W_OK, AT_EACCESS) != 0)
+      pathCheck.error = "is not writable";
+  };
+
+  // at least 8 checks per thread (a few paths are checked inline)
+  size_t num_threads = std::min((num_checks + 7)/8,
+    size_t(std::min(64U, 4*std::max(1U, std::thread::hardware_concurrency()))));
+
+  if (num_threads <= 1) {
+    for (auto &pathCheck : pathChecks)
+      checkPath(pathCheck);
+  }
+  else {
+    std::atomic<size_t> next { 0 };
+
+    auto worker = [&]() {
+      for (auto i = next++; i < num_checks; i = next++)
+        checkPath(pathChecks[i]);
+    };
+
+    std::vector<std::thread> threads;
+
+    for (size_t i = 1; i < num_threads; ++i)
+      threads.emplace_back(worker);
+
+    worker();
+
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  // report in argument order
+  for (const auto &pathCheck : pathChecks) {
+    if (pathCheck.error)
+      addError(std::string("Path ") + pathCheck.path + " for " + pathCheck.arg->getName() +
+               " " + pathCheck.error);
+  }
+}
+
+void
+CArgs::
+addError(const std::string &msg)
+{
+  errors_.push_back(msg);
+}
+
+bool
+CArgs::
+reportErrors() const
+{
+  for (const auto &error : errors_)
+    std::cerr << "Error: " << error << "\n";
+
+  return errors_.empty();
+}
+
+void
+CArgs::
+setIntegerRange(const std::string &name, long min, long max)
+{
+  CArgInteger *arg = lookupIntegerArg(name);
+
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Integer"));
+    return;
+  }
+
+  if (min > max) {
+    CTHROW("Invalid Range");
+    return;
+  }
+
+  arg->setRange(min, max);
+}
+
+void
+CArgs::
+setAction(const std::string &name, const ActionProc &proc)
+{
+  int i = getArgIndex(name);
+
+  if (i < 0) {
+    CTHROW(std::string("Option ") + name + std::string(" not found"));
+    return;
+  }
+
+  if (actions_.size() < args_.size())
+    actions_.resize(args_.size());
+
+  actions_[size_t(i)] = proc;
+}
+
+void
+CArgs::
+setBooleanAction(const std::string &name, const BooleanAction &proc)
+{
+  if (! lookupBooleanArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Boolean"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgBoolean &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setIntegerAction(const std::string &name, const IntegerAction &proc)
+{
+  if (! lookupIntegerArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Integer"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgInteger &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setRealAction(const std::string &name, const RealAction &proc)
+{
+  if (! lookupRealArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Real"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgReal &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setStringAction(const std::string &name, const StringAction &proc)
+{
+  if      (lookupStringArg(name)) {
+    setAction(name, [proc](const CArg &arg) {
+      proc(static_cast<const CArgString &>(arg).getValue()); });
+  }
+  else if (lookupStringListArg(name)) {
+    setAction(name, [proc](const CArg &arg) {
+      proc(static_cast<const CArgStringList &>(arg).getValue().back()); });
+  }
+  else {
+    CTHROW(std::string("Option ") + name + std::string(" is not String"));
+  }
+}
+
+void
+CArgs::
+setChoiceAction(const std::string &name, const IntegerAction &proc)
+{
+  if (! lookupChoiceArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Choice"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgChoice &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setSizeAction(const std::string &name, const IntegerAction &proc)
+{
+  if (! lookupSizeArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Size"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgSize &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setDurationAction(const std::string &name, const IntegerAction &proc)
+{
+  if (! lookupDurationArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Duration"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgDuration &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setRateAction(const std::string &name, const RealAction &proc)
+{
+  if (! lookupRateArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Rate"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(static_cast<const CArgRate &>(arg).getValue()); });
+}
+
+void
+CArgs::
+setPathAction(const std::string &name, const StringAction &proc)
+{
+  if (! lookupPathArg(name)) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Path"));
+    return;
+  }
+
+  setAction(name, [proc](const CArg &arg) {
+    proc(std::string(static_cast<const CArgPath &>(arg).getValue())); });
+}
+
+void
+CArgs::
+setRealRange(const std::string &name, double min, double max)
+{
+  CArgReal *arg = lookupRealArg(name);
+
+  if (! arg) {
+    CTHROW(std::string("Option ") + name + std::string(" is not Real"));
+    return;
+  }
+
+  if (min > max) {
+    CTHROW("Invalid Range");
+    return;
+  }
+
+  arg->setRange(min, max);
+}
+
+void
+CArgs::
+setStringPattern(const std::string &name, const std::string &pattern)
+{
+  CArgString *arg = lookupStringArg(name);
+
+  if (arg) {
+    arg->setPattern(pattern);
+    return;
+  }
+
+  CArgStringList *arg1 = lookupStringListArg(name);
+
+  if (! arg1) {
+    CTHROW(std::string("Option ") + name + std::string(" is not String"));
+    return;
+  }
+
+  arg1->setPattern(pattern);
+}
+
+bool
+CArgs::
+checkOption(const char *arg, std::string &opt)
+{
+  opt = "";
+
+  if (strcmp(arg, "--") == 0) {
+    skip_remaining_ = true;
+
+    return true;
+  }
+
+  if (skip_remaining_ || arg[0] != '-')
+    return false;
+
+  opt = &arg[1];
+
+  return true;
+}
+
+void
+CArgs::
+unhandledOpt(const std::string &opt)
+{
+  if (opt != "")
+    std::cerr << "Unhandled option: -" << opt << "\n";
+}
+
+void
+CArgs::
+usage(const std::string &cmd) const
+{
+  uint max_name_len = 0;
+
+  std::cerr << cmd << " ";
+
+  for (auto &arg : args_) {
+    if (! arg->getRequired())
+      std::cerr << "[";
+
+    std::cerr << arg->getNameView();
+
+    max_name_len = std::max(uint(arg->getNameView().size()), max_name_len);
+
+    CArgType type = arg->getType();
+
+    if (type != CARG_TYPE_BOOLEAN && ! arg->getAttached())
+      std::cerr << " ";
+
+    if      (type == CARG_TYPE_INTEGER)
+      std::cerr << "<integer>";
+    else if (type == CARG_TYPE_REAL)
+      std::cerr << "<real>";
+    else if (type == CARG_TYPE_STRING)
+      std::cerr << "<string>";
+    else if (type == CARG_TYPE_CHOICE)
+      std::cerr << "<choice>";
+    else if (type == CARG_TYPE_SIZE)
+      std::cerr << "<size>";
+    else if (type == CARG_TYPE_DURATION)
+      std::cerr << "<duration>";
+    else if (type == CARG_TYPE_RATE)
+      std::cerr << "<rate>";
+    else if (type == CARG_TYPE_PATH)
+      std::cerr << "<path>";
+    else if (type == CARG_TYPE_CUSTOM)
+      std::cerr << "<" << static_cast<CArgCustom *>(arg)->getCustomType().name << ">";
+
+    if (! arg->getRequired())
+      std::cerr << "]";
+
+    std::cerr << " ";
+  }
+
+  std::cerr << "\n";
+
+  for (auto &arg : args_) {
+    std::cerr << " ";
+
+    std::cerr << arg->getNameView();
+
+    for (uint i = 0; i < max_name_len - arg->getNameView().size(); ++i)
+      std::cerr << " ";
+
+    std::cerr << " : ";
+
+    std::cerr << arg->getDesc();
+
+    std::cerr << "\n";
+  }
+}
+
+void
+CArgs::
+print() const
+{
+  for (auto &arg : args_)
+    arg->print();
+}
+
+namespace {
+
+// heap bytes used by string (none if stored in string object)
+size_t
+stringHeap(const std::string &str)
+{
+  return (str.capacity() > std::string().capacity() ? str.capacity() + 1 : 0);
+}
+
+size_t
+stringListHeap(const std::vector<std::string> &strs)
+{
+  size_t n = strs.capacity()*sizeof(std::string);
+
+  for (const auto &str : strs)
+    n += stringHeap(str);
+
+  return n;
+}
+
+}
+
+// object size is from the option type and heap size from the option's value and
+// error strings (allocator overhead and pattern/choice tables are not included).
+// Names, descriptions, defaults and choices are views of the format string or
+// string pool which are reported separately.
+void
+CArgs::
+printMemory(std::ostream &os) const
+{
+  size_t total = 0;
+
+  for (const auto &arg : args_) {
+    size_t objSize = sizeof(CArg);
+    size_t heap    = stringHeap(arg->getError());
+
+    switch (arg->getType()) {
+      case CARG_TYPE_BOOLEAN : objSize = sizeof(CArgBoolean ); break;
+      case CARG_TYPE_INTEGER : objSize = sizeof(CArgInteger ); break;
+      case CARG_TYPE_REAL    : objSize = sizeof(CArgReal    ); break;
+      case CARG_TYPE_CHOICE  : objSize = sizeof(CArgChoice  ); break;
+      case CARG_TYPE_SIZE    : objSize = sizeof(CArgSize    ); break;
+      case CARG_TYPE_DURATION: objSize = sizeof(CArgDuration); break;
+      case CARG_TYPE_RATE    : objSize = sizeof(CArgRate    ); break;
+      case CARG_TYPE_CUSTOM  : objSize = sizeof(CArgCustom  ); break;
+      case CARG_TYPE_STRING: {
+        if (auto *larg = dynamic_cast<const CArgStringList *>(arg)) {
+          objSize  = sizeof(CArgStringList);
+          heap    += stringListHeap(larg->getValue());
+        }
+        else {
+          objSize  = sizeof(CArgString);
+          heap    += stringHeap(static_cast<const CArgString *>(arg)->getValue());
+        }
+
+        break;
+      }
+      case CARG_TYPE_PATH: {
+        objSize  = sizeof(CArgPath);
+        heap    += stringListHeap(static_cast<const CArgPath *>(arg)->getValues());
+
+        break;
+      }
+      default:
+        break;
+    }
+
+    os << arg->getNameView() << " " << objSize << " + " << heap << " bytes\n";
+
+    total += objSize + heap;
+  }
+
+  // per option parse index and action table
+  size_t index = args_.size()*(sizeof(CArg *) + 2*sizeof(uint32_t)) +
+                 actions_.size()*sizeof(ActionProc);
+
+  total += index;
+
+  size_t strings = def_.capacity() + 1 + pool_.memUsage();
+
+  total += strings;
+
+  os << "Index " << index << " bytes\n";
+  os << "Strings " << strings << " bytes (format " << def_.size() <<
+        ", pool " << pool_.memUsage() << ")\n";
+  os << "Total " << total << " bytes";
+
+  if (! args_.empty())
+    os << " (" << double(total)/double(args_.size()) << " per option)";
+
+  os << "\n";
+}
+
+//-------
+
+CArg::
+CArg(std::string_view name, CArgType type, int flags, bool attached, std::string_view desc) :
+ name_(name), type_(type), flags_(flags), attached_(attached), desc_(desc)
+{
+}
+
+namespace {
+
+bool
+caseEqual(std::string_view str1, std::string_view str2)
+{
+  if (str1.size() != str2.size())
+    return false;
+
+  for (size_t i = 0; i < str1.size(); ++i)
+    if (CArgEnumUtil::foldChar(str1[i]) != CArgEnumUtil::foldChar(str2[i]))
+      return false;
+
+  return true;
+}
+
+}
+
+bool
+CArg::
+optionCmp(const std::string &opt)
+{
+  std::string_view opt1 = opt;
+
+  if (attached_) {
+    if (opt1.size() <= name_.size())
+      return false;
+
+    opt1 = opt1.substr(0, name_.size());
+  }
+
+  if (flags_ & CARG_FLAG_NO_CASE)
+    return caseEqual(opt1, name_);
+  else
+    return (opt1 == name_);
+}
+
+bool
+CArg::
+nameCmp(std::string_view name)
+{
+  if (flags_ & CARG_FLAG_NO_CASE)
+    return caseEqual(name, name_);
+  else
+    return (name == name_);
+}
+
+int
+CArg::
+getNumArgs() const
+{
+  if (attached_)
+    return 0;
+  else
+    return getNumArgs1();
+}
+
+bool
+CArg::
+setValue(const char *opt, const char **args, int num_args)
+{
+  error_ = "";
+
+  if (! attached_)
+    set_ = setValue1(args, num_args);
+  else {
+    char *arg0 = strndup_m(&opt[name_.size()], strlen(opt) - name_.size());
+
+    char **args1 = new char * [uint(num_args + 1)];
+
+    args1[0] = arg0;
+
+    for (int i = 1; i <= num_args; i++)
+      args1[i] = const_cast<char *>(args[i - 1]);
+
+    set_ = setValue1(const_cast<const char **>(args1), num_args + 1);
+
+    delete [] args1;
+
+    free(arg0);
+  }
+
+  return set_;
+}
+
+bool
+CArg::
+setValue(const std::string &opt, const std::vector<std::string> &args)
+{
+  auto   num_args1 = args.size();
+  char **args1     = new char * [num_args1];
+
+  for (uint i = 0; i < num_args1; ++i)
+    args1[i] = const_cast<char *>(args[i].c_str());
+
+  bool rc = setValue(opt.c_str(), const_cast<const char **>(args1), int(num_args1));
+
+  delete [] args1;
+
+  return rc;
+}
+
+bool
+CArg::
+setArg(va_list *vargs)
+{
+  if (flags_ & CARG_FLAG_SKIP)
+    return true;
+
+  return setArg1(vargs);
+}
+
+void
+CArg::
+print() const
+{
+  std::cout << "Name     " << name_                           << "\n";
+  std::cout << "Type     " << typeToString(type_)             << "\n";
+  std::cout << "Flags    " << flagsToString(flags_)           << "\n";
+  std::cout << "Attached " << (attached_  ? "true" : "false") << "\n";
+}
+
+std::string
+CArg::
+typeToString(CArgType type) const
+{
+  switch (type) {
+    case CARG_TYPE_BOOLEAN:
+      return "Boolean";
+    case CARG_TYPE_INTEGER:
+      return "Integer";
+    case CARG_TYPE_REAL:
+      return "Real";
+    case CARG_TYPE_STRING:
+      return "String";
+    case CARG_TYPE_CHOICE:
+      return "Choice";
+    case CARG_TYPE_SIZE:
+      return "Size";
+    case CARG_TYPE_DURATION:
+      return "Duration";
+    case CARG_TYPE_RATE:
+      return "Rate";
+    case CARG_TYPE_CUSTOM:
+      return "Custom";
+    case CARG_TYPE_PATH:
+      return "Path";
+    default:
+      return "????";
+  }
+}
+
+std::string
+CArg::
+flagsToString(int flags) const
+{
+  std::string desc;
+
+  if (flags == CARG_FLAG_NONE)
+    return "None";
+
+  if (flags & CARG_FLAG_NO_CASE)
+    desc += "No Case ";
+
+  if (flags & CARG_FLAG_REQUIRED)
+    desc += "Required ";
+
+  if (flags & CARG_FLAG_SKIP)
+    desc += "Skip ";
+
+  return desc;
+}
+
+//------
+
+CArgBoolean::
+CArgBoolean(std::string_view name, int flags, bool defval, std::string_view desc) :
+ CArg(name, CARG_TYPE_BOOLEAN, flags, false, desc), value_(defval), defval_(defval)
+{
+}
+
+bool
+CArgBoolean::
+setValue1(const char **, int)
+{
+  value_ = true;
+
+  return true;
+}
+
+bool
+CArgBoolean::
+setArg1(va_list *vargs)
+{
+  bool *value = va_arg(*vargs, bool *);
+
+  if (! value)
+    return false;
+
+  *value = value_;
+
+  return true;
+}
+
+void
+CArgBoolean::
+getValueStrings(std::vector<std::string> &values) const
+{
+  values.push_back(value_ ? "1" : "0");
+}
+
+void
+CArgBoolean::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(uint8_t(value_));
+}
+
+void
+CArgBoolean::
+print() const
+{
+  CArg::print();
+
+  std::cout << "Value    " << (value_  ? "true" : "false") << "\n";
+  std::cout << "Default  " << (defval_ ? "true" : "false") << "\n";
+}
+
+//-------
+
+CArgInteger::
+CArgInteger(std::string_view name, int flags, long defval, bool attached,
+            std::string_view desc) :
+ CArg(name, CARG_TYPE_INTEGER, flags, attached, desc), value_(defval), defval_(defval) {
+}
+
+bool
+CArgInteger::
+setValue1(const char **args, int)
+{
+  if (! CStrUtil::isInteger(args[0]))
+    return false;
+
+  long value = CStrUtil::toInteger(args[0]);
+
+  if (value < min_ || value > max_) {
+    setError("out of range [" + std::to_string(min_) + "," + std::to_string(max_) + "]");
+    return false;
+  }
+
+  value_ = value;
+
+  return true;
+}
+
+bool
+CArgInteger::
+setArg1(va_list *vargs)
+{
+  long *value = va_arg(*vargs, long *);
+
+  if (! value)
+    return false;
+
+  *value = value_;
+
+  return true;
+}
+
+void
+CArgInteger::
+getValueStrings(std::vector<std::string> &values) const
+{
+  values.push_back(std::to_string(value_));
+}
+
+void
+CArgInteger::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(value_);
+}
+
+void
+CArgInteger::
+print() const
+{
+  CArg::print();
+
+  std::cout << "Value    " << value_  << "\n";
+  std::cout << "Default  " << defval_ << "\n";
+}
+
+//-------
+
+CArgReal::
+CArgReal(std::string_view name, int flags, double defval, bool attached,
+         std::string_view desc) :
+ CArg(name, CARG_TYPE_REAL, flags, attached, desc), value_(defval), defval_(defval)
+{
+}
+
+bool
+CArgReal::
+setValue1(const char **args, int)
+{
+  if (! CStrUtil::isReal(args[0]))
+    return false;
+
+  double value = CStrUtil::toReal(args[0]);
+
+  if (value < min_ || value > max_) {
+    setError("out of range [" + std::to_string(min_) + "," + std::to_string(max_) + "]");
+    return false;
+  }
+
+  value_ = value;
+
+  return true;
+}
+
+bool
+CArgReal::
+setArg1(va_list *vargs)
+{
+  double *value = va_arg(*vargs, double *);
+
+  if (! value)
+    return false;
+
+  *value = value_;
+
+  return true;
+}
+
+void
+CArgReal::
+getValueStrings(std::vector<std::string> &values) const
+{
+  // shortest string which converts back to the same value
+  char buffer[32];
+
+  for (int precision = 15; precision <= 17; ++precision) {
+    snprintf(buffer, sizeof(buffer), "%.*g", precision, value_);
+
+    if (strtod(buffer, nullptr) == value_)
+      break;
+  }
+
+  values.push_back(buffer);
+}
+
+void
+CArgReal::
+hashValue(CArgHasher &hasher) const
+{
+  // -0 and 0 are equal, all NaNs are equal
+  double r = value_;
+
+  if (r == 0.0)
+    r = 0.0;
+
+  if (std::isnan(r))
+    r = std::numeric_limits<double>::quiet_NaN();
+
+  hasher.add(r);
+}
+
+void
+CArgReal::
+print() const
+{
+  CArg::print();
+
+  std::cout << "Value    " << value_  << "\n";
+  std::cout << "Default  " << defval_ << "\n";
+}
+
+//------
+
+class CArgPattern {
+ public:
+  CArgPattern(const std::string &pattern) :
+   pattern_(pattern) {
+    try {
+      regex_ = std::regex(pattern, std::regex::extended | std::regex::nosubs);
+    }
+    catch (const std::regex_error &) {
+      CTHROW(std::string("Invalid Pattern ") + pattern);
+    }
+  }
+
+  const std::string &getPattern() const { return pattern_; }
+
+  bool match(const char *str) const { return std::regex_match(str, regex_); }
+
+ private:
+  std::string pattern_;
+  std::regex  regex_;
+};
+
+//------
+
+CArgString::
+CArgString(std::string_view name, int flags, std::string_view defval, bool attached,
+           std::string_view desc) :
+ CArg(name, CARG_TYPE_STRING, flags, attached, desc), value_(defval), defval_(defval)
+{
+}
+
+CArgString::
+~CArgString()
+{
+}
+
+void
+CArgString::
+setPattern(const std::string &pattern)
+{
+  pattern_ = std::make_unique<CArgPattern>(pattern);
+}
+
+bool
+CArgString::
+setValue1(const char **args, int)
+{
+  if (pattern_ && ! pattern_->match(args[0])) {
+    setError("does not match /" + pattern_->getPattern() + "/");
+    return false;
+  }
+
+  value_ = args[0];
+
+  return true;
+}
+
+bool
+CArgString::
+setArg1(va_list *vargs)
+{
+  std::string *value = va_arg(*vargs, std::string *);
+
+  if (! value)
+    return false;
+
+  *value = value_;
+
+  return true;
+}
+
+void
+CArgString::
+getValueStrings(std::vector<std::string> &values) const
+{
+  values.push_back(value_);
+}
+
+void
+CArgString::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.addString(value_);
+}
+
+void
+CArgString::
+print() const
+{
+  CArg::print();
+
+  std::cout << "Value    " << value_  << "\n";
+  std::cout << "Default  " << defval_ << "\n";
+}
+
+//------
+
+CArgStringList::
+CArgStringList(std::string_view name, int flags, std::string_view defval, bool attached,
+               std::string_view desc) :
+ CArg(name, CARG_TYPE_STRING, flags, attached, desc), defval_(defval)
+{
+}
+
+CArgStringList::
+~CArgStringList()
+{
+}
+
+void
+CArgStringList::
+setPattern(const std::string &pattern)
+{
+  pattern_ = std::make_unique<CArgPattern>(pattern);
+}
+
+bool
+CArgStringList::
+setValue1(const char **args, int)
+{
+  if (pattern_ && ! pattern_->match(args[0])) {
+    setError("does not match /" + pattern_->getPattern() + "/");
+    return false;
+  }
+
+  values_.push_back(args[0]);
+
+  return true;
+}
+
+bool
+CArgStringList::
+setArg1(va_list *vargs)
+{
+  std::string *value = va_arg(*vargs, std::string *);
+
+  if (! value)
+    return false;
+
+  if (values_.empty())
+    return false;
+
+  *value = values_[0];
+
+  return true;
+}
+
+void
+CArgStringList::
+getValueStrings(std::vector<std::string> &values) const
+{
+  for (const auto &value : values_)
+    values.push_back(value);
+}
+
+void
+CArgStringList::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(uint64_t(values_.size()));
+
+  for (const auto &value : values_)
+    hasher.addString(value);
+}
+
+void
+CArgStringList::
+print() const
+{
+  CArg::print();
+
+  auto num_values = values_.size();
+
+  std::cout << "Values   ";
+
+  for (uint i = 0; i < num_values; ++i) {
+    if (i > 0)
+      std::cout << ", ";
+
+    std::cout << values_[i];
+  }
+
+  std::cout << "\n";
+
+  std::cout << "Default  " << defval_ << "\n";
+}
+
+//------
+
+CArgChoice::
+CArgChoice(std::string_view name, int flags, const ChoiceList &choices, long defval,
+           bool attached, std::string_view desc) :
+ CArg(name, CARG_TYPE_CHOICE, flags,  attached, desc), value_(defval), defval_(defval)
+{
+  // split '<name>=<value>' choices
+  auto num_choices = choices.size();
+
+  ChoiceList names;
+  ValueList  values;
+
+  names .reserve(num_choices);
+  values.reserve(num_choices);
+
+  for (uint i = 0; i < num_choices; ++i) {
+    std::string_view choice = choices[i];
+
+    std::string_view name1 = choice;
+    long             value = long(i);
+
+    auto pos = choice.find('=');
+
+    if (pos != std::string_view::npos) {
+      name1 = choice.substr(0, pos);
+
+      std::string vstr(choice.substr(pos + 1));
+
+      if (! CStrUtil::isInteger(vstr)) {
+        CTHROW(std::string("Invalid Value for Choice ") + std::string(choice));
+        return;
+      }
+
+      value = CStrUtil::toInteger(vstr);
+    }
+
+    names .push_back(name1);
+    values.push_back(value);
+  }
+
+  addChoices(names, values);
+}
+
+CArgChoice::
+CArgChoice(std::string_view name, int flags, const ChoiceList &choices, const ValueList &values,
+           long defval, bool attached, std::string_view desc) :
+ CArg(name, CARG_TYPE_CHOICE, flags,  attached, desc), value_(defval), defval_(defval)
+{
+  addChoices(choices, values);
+}
+
+// build hash of (case folded) name to value
+void
+CArgChoice::
+addChoices(const ChoiceList &names, const ValueList &values)
+{
+  bool no_case = (getFlags() & CARG_FLAG_NO_CASE);
+
+  auto num_choices = names.size();
+
+  choices_.reserve(num_choices);
+  values_ .reserve(num_choices);
+
+  choiceMap_.reserve(num_choices);
+
+  // folded keys are stored in one string (reserved so views stay valid)
+  if (no_case) {
+    size_t len = 0;
+
+    for (const auto &name : names)
+      len += name.size();
+
+    foldedNames_.reserve(len);
+  }
+
+  for (uint i = 0; i < num_choices; ++i) {
+    std::string_view key = names[i];
+
+    if (no_case) {
+      auto pos = foldedNames_.size();
+
+      for (auto c : names[i])
+        foldedNames_ += char(tolower(static_cast<unsigned char>(c)));
+
+      key = std::string_view(foldedNames_).substr(pos);
+    }
+
+    if (! choiceMap_.emplace(key, values[i]).second) {
+      CTHROW(std::string("Duplicate Choice ") + std::string(names[i]));
+      return;
+    }
+
+    choices_.push_back(names [i]);
+    values_ .push_back(values[i]);
+  }
+}
+
+bool
+CArgChoice::
+setValue1(const char **args, int)
+{
+  long value;
+
+  if (! lookupChoice(args[0], value))
+    return false;
+
+  value_ = value;
+
+  return true;
+}
+
+bool
+CArgChoice::
+lookupChoice(const std::string &choice, long &value) const
+{
+  auto p = choiceMap_.find(getFlags() & CARG_FLAG_NO_CASE ? foldCase(choice) : choice);
+
+  if (p == choiceMap_.end())
+    return false;
+
+  value = (*p).second;
+
+  return true;
+}
+
+bool
+CArgChoice::
+setArg1(va_list *vargs)
+{
+  long *value = va_arg(*vargs, long *);
+
+  if (! value)
+    return false;
+
+  *value = value_;
+
+  return true;
+}
+
+void
+CArgChoice::
+getValueStrings(std::vector<std::string> &values) const
+{
+  auto num_choices = choices_.size();
+
+  for (uint i = 0; i < num_choices; ++i) {
+    if (values_[i] == value_) {
+      values.push_back(std::string(choices_[i]));
+      return;
+    }
+  }
+
+  values.push_back(std::to_string(value_));
+}
+
+void
+CArgChoice::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(value_);
+}
+
+void
+CArgChoice::
+print() const
+{
+  CArg::print();
+
+  std::cout << "Value    " << value_  << "\n";
+  std::cout << "Default  " << defval_ << "\n";
+
+  std::cout << "Choices ";
+
+  auto num_choices = choices_.size();
+
+  for (uint i = 0; i < num_choices; ++i)
+    std::cout << " " << choices_[i] << "=" << values_[i];
+
+  std::cout << "\n";
+}
+
+//------
+
+// unit suffix to scale lookup tables for size, duration and rate values
+struct CArgUnit {
+  const char *suffix;
+  long        scale;
+};
+
+static const CArgUnit sizeUnits[] = {
+  { ""   , 1L       }, { "B"  , 1L       },
+  { "k"  , 1000L    }, { "K"  , 1000L    }, { "kB" , 1000L    }, { "KB" , 1000L    },
+  { "Ki" , 1L << 10 }, { "KiB", 1L << 10 },
+  { "M"  , 1000000L }, { "MB" , 1000000L }, { "Mi" , 1L << 20 }, { "MiB", 1L << 20 },
+  { "G"  , 1000000000L }, { "GB" , 1000000000L }, { "Gi" , 1L << 30 }, { "GiB", 1L << 30 },
+  { "T"  , 1000000000000L }, { "TB" , 1000000000000L }, { "Ti" , 1L << 40 }, { "TiB", 1L << 40 },
+  { "P"  , 1000000000000000L }, { "PB" , 1000000000000000L },
+  { "Pi" , 1L << 50 }, { "PiB", 1L << 50 },
+  { "E"  , 1000000000000000000L }, { "EB" , 1000000000000000000L },
+  { "Ei" , 1L << 60 }, { "EiB", 1L << 60 },
+};
+
+static const CArgUnit durationUnits[] = {
+  { ""   , 1000000000L }, { "ns" , 1L }, { "us" , 1000L }, { "ms" , 1000000L },
+  { "s"  , 1000000000L }, { "m"  , 60000000000L }, { "min", 60000000000L },
+  { "h"  , 3600000000000L }, { "d"  , 86400000000000L },
+};
+
+static const CArgUnit countUnits[] = {
+  { ""   , 1L }, { "k"  , 1000L }, { "K"  , 1000L }, { "M"  , 1000000L },
+  { "G"  , 1000000000L }, { "T"  , 1000000000000L },
+};
+
+template<size_t N>
+static bool
+lookupUnit(const char *str, size_t len, const CArgUnit (&units)[N], long &scale)
+{
+  for (const auto &unit : units) {
+    if (strncmp(unit.suffix, str, len) == 0 && unit.suffix[len] == '\0') {
+      scale = unit.scale;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// parse '<digits>[.<digits>]<unit>' up to end of string or '/', with overflow check.
+// Any fraction of the smallest unit is truncated unless den is given, then the
+// exact value is value/den (den is 1 for an integral value).
+template<size_t N>
+static bool
+parseScaledValue(const char *&str, const CArgUnit (&units)[N], long &value, long *den=nullptr)
+{
+  const char *p = str;
+
+  uint64_t ivalue = 0;
+
+  bool digits = false;
+
+  for ( ; isdigit(*p); ++p) {
+    if (__builtin_mul_overflow(ivalue, 10, &ivalue) ||
+        __builtin_add_overflow(ivalue, uint64_t(*p - '0'), &ivalue))
+      return false;
+
+    digits = true;
+  }
+
+  // fraction (extra digits beyond 18 are ignored)
+  uint64_t fvalue = 0, fscale = 1;
+
+  if (*p == '.') {
+    ++p;
+
+    for ( ; isdigit(*p); ++p) {
+      if (fscale < 1000000000000000000ULL) {
+        fvalue  = 10*fvalue + uint64_t(*p - '0');
+        fscale *= 10;
+      }
+
+      digits = true;
+    }
   }
-}
 
-std::string
-CArg::
-flagsToString(int flags) const
-{
-  std::string desc;
+  if (! digits)
+    return false;
 
-  if (flags == CARG_FLAG_NONE)
-    return "None";
+  const char *s = p;
 
-  if (flags & CARG_FLAG_NO_CASE)
-    desc += "No Case ";
+  while (*p != '\0' && *p != '/')
+    ++p;
 
-  if (flags & CARG_FLAG_REQUIRED)
-    desc += "Required ";
+  long scale;
 
-  if (flags & CARG_FLAG_SKIP)
-    desc += "Skip ";
+  if (! lookupUnit(s, size_t(p - s), units, scale))
+    return false;
 
-  return desc;
-}
+  uint64_t value1;
 
-//------
+  if (__builtin_mul_overflow(ivalue, uint64_t(scale), &value1))
+    return false;
 
-CArgBoolean::
-CArgBoolean(const std::string &name, int flags, bool defval, const std::string &desc) :
- CArg(name, CARG_TYPE_BOOLEAN, flags, false, desc), value_(defval), defval_(defval)
-{
-}
+  auto fvalue1 = (unsigned __int128) fvalue*uint64_t(scale);
 
-bool
-CArgBoolean::
-setValue1(const char **, int)
-{
-  value_ = true;
+  if (__builtin_add_overflow(value1, uint64_t(fvalue1/fscale), &value1))
+    return false;
 
-  return true;
-}
+  uint64_t den1 = 1;
 
-bool
-CArgBoolean::
-setArg1(va_list *vargs)
-{
-  bool *value = va_arg(*vargs, bool *);
+  // value1 + rem/fscale as (reduced) fraction
+  auto rem = uint64_t(fvalue1 % fscale);
 
-  if (! value)
+  if (den && rem != 0) {
+    uint64_t g = std::gcd(rem, fscale);
+
+    den1 = fscale/g;
+
+    if (__builtin_mul_overflow(value1, den1, &value1) ||
+        __builtin_add_overflow(value1, rem/g, &value1))
+      return false;
+  }
+
+  if (value1 > uint64_t(std::numeric_limits<long>::max()))
     return false;
 
-  *value = value_;
+  value = long(value1);
+
+  if (den)
+    *den = long(den1);
+
+  str = p;
 
   return true;
 }
 
-void
-CArgBoolean::
-print() const
+// format value using largest suffix (in order) which divides it exactly
+template<size_t N, size_t M>
+static std::string
+formatScaledValue(long value, const CArgUnit (&units)[N], const char *(&suffixes)[M])
 {
-  CArg::print();
+  if (value == 0)
+    return "0";
 
-  std::cout << "Value    " << (value_  ? "true" : "false") << "\n";
-  std::cout << "Default  " << (defval_ ? "true" : "false") << "\n";
+  for (const auto &suffix : suffixes) {
+    long scale;
+
+    if (lookupUnit(suffix, strlen(suffix), units, scale) && value % scale == 0)
+      return std::to_string(value/scale) + suffix;
+  }
+
+  return std::to_string(value);
 }
 
-//-------
+//------
 
-CArgInteger::
-CArgInteger(const std::string &name, int flags, long defval, bool attached,
-            const std::string &desc) :
- CArg(name, CARG_TYPE_INTEGER, flags, attached, desc), value_(defval), defval_(defval) {
+CArgSize::
+CArgSize(std::string_view name, int flags, long defval, bool attached,
+         std::string_view desc) :
+ CArg(name, CARG_TYPE_SIZE, flags, attached, desc), value_(defval), defval_(defval)
+{
 }
 
 bool
-CArgInteger::
+CArgSize::
+parseValue(const char *str, long &value)
+{
+  return (parseScaledValue(str, sizeUnits, value) && *str == '\0');
+}
+
+bool
+CArgSize::
 setValue1(const char **args, int)
 {
-  if (! CStrUtil::isInteger(args[0]))
+  long value;
+
+  if (! parseValue(args[0], value)) {
+    setError("invalid size or size too large");
     return false;
+  }
 
-  value_ = int(CStrUtil::toInteger(args[0]));
+  value_ = value;
 
   return true;
 }
 
 bool
-CArgInteger::
+CArgSize::
 setArg1(va_list *vargs)
 {
   long *value = va_arg(*vargs, long *);
@@ -1671,7 +3993,24 @@ setArg1(va_list *vargs)
 }
 
 void
-CArgInteger::
+CArgSize::
+getValueStrings(std::vector<std::string> &values) const
+{
+  static const char *suffixes[] = {
+    "EiB", "EB", "PiB", "PB", "TiB", "TB", "GiB", "GB", "MiB", "MB", "KiB", "kB" };
+
+  values.push_back(formatScaledValue(value_, sizeUnits, suffixes));
+}
+
+void
+CArgSize::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(value_);
+}
+
+void
+CArgSize::
 print() const
 {
   CArg::print();
@@ -1680,32 +4019,43 @@ print() const
   std::cout << "Default  " << defval_ << "\n";
 }
 
-//-------
+//------
 
-CArgReal::
-CArgReal(const std::string &name, int flags, double defval, bool attached,
-         const std::string &desc) :
- CArg(name, CARG_TYPE_REAL, flags, attached, desc), value_(defval), defval_(defval)
+CArgDuration::
+CArgDuration(std::string_view name, int flags, long defval, bool attached,
+             std::string_view desc) :
+ CArg(name, CARG_TYPE_DURATION, flags, attached, desc), value_(defval), defval_(defval)
 {
 }
 
 bool
-CArgReal::
+CArgDuration::
+parseValue(const char *str, long &value)
+{
+  return (parseScaledValue(str, durationUnits, value) && *str == '\0');
+}
+
+bool
+CArgDuration::
 setValue1(const char **args, int)
 {
-  if (! CStrUtil::isReal(args[0]))
+  long value;
+
+  if (! parseValue(args[0], value)) {
+    setError("invalid duration or duration too large");
     return false;
+  }
 
-  value_ = CStrUtil::toReal(args[0]);
+  value_ = value;
 
   return true;
 }
 
 bool
-CArgReal::
+CArgDuration::
 setArg1(va_list *vargs)
 {
-  double *value = va_arg(*vargs, double *);
+  long *value = va_arg(*vargs, long *);
 
   if (! value)
     return false;
@@ -1716,7 +4066,23 @@ setArg1(va_list *vargs)
 }
 
 void
-CArgReal::
+CArgDuration::
+getValueStrings(std::vector<std::string> &values) const
+{
+  static const char *suffixes[] = { "d", "h", "m", "s", "ms", "us", "ns" };
+
+  values.push_back(formatScaledValue(value_, durationUnits, suffixes));
+}
+
+void
+CArgDuration::
+hashValue(CArgHasher &hasher) const
+{
+  hasher.add(value_);
+}
+
+void
+CArgDuration::
 print() const
 {
   CArg::print();
@@ -1727,167 +4093,311 @@ print() const
 
 //------
 
-CArgString::
-CArgString(const std::string &name, int flags, const std::string &defval, bool attached,
-           const std::string &desc) :
- CArg(name, CARG_TYPE_STRING, flags, attached, desc), value_(defval), defval_(defval)
+CArgRate::
+CArgRate(std::string_view name, int flags, long defcount, long defperiod, bool attached,
+         std::string_view desc) :
+ CArg(name, CARG_TYPE_RATE, flags, attached, desc), count_(defcount), period_(defperiod),
+ defcount_(defcount), defperiod_(defperiod)
 {
 }
 
 bool
-CArgString::
+CArgRate::
+parseValue(const char *str, long &count, long &period)
+{
+  // fractional count (e.g. 0.5/s) is kept exact by scaling period (1 per 2s)
+  long den;
+
+  if (! parseScaledValue(str, countUnits, count, &den))
+    return false;
+
+  if (*str == '\0')
+    period = 1000000000L;
+  else {
+    // skip '/' and lookup period unit
+    ++str;
+
+    auto len = strlen(str);
+
+    if (len == 0 || ! lookupUnit(str, len, durationUnits, period))
+      return false;
+  }
+
+  if (__builtin_mul_overflow(period, den, &period))
+    return false;
+
+  return true;
+}
+
+bool
+CArgRate::
 setValue1(const char **args, int)
 {
-  value_ = args[0];
+  long count, period;
+
+  if (! parseValue(args[0], count, period)) {
+    setError("invalid rate or rate too large");
+    return false;
+  }
+
+  count_  = count;
+  period_ = period;
 
   return true;
 }
 
 bool
-CArgString::
+CArgRate::
 setArg1(va_list *vargs)
 {
-  std::string *value = va_arg(*vargs, std::string *);
+  double *value = va_arg(*vargs, double *);
 
   if (! value)
     return false;
 
-  *value = value_;
+  *value = getValue();
 
   return true;
 }
 
 void
-CArgString::
+CArgRate::
+getValueStrings(std::vector<std::string> &values) const
+{
+  static const char *suffixes[] = { "T", "G", "M", "k" };
+  static const char *periods [] = { "d", "h", "m", "s", "ms", "us", "ns" };
+
+  std::string str = formatScaledValue(count_, countUnits, suffixes);
+
+  for (const auto &period : periods) {
+    long scale;
+
+    if (lookupUnit(period, strlen(period), durationUnits, scale) && scale == period_) {
+      values.push_back(str + "/" + period);
+      return;
+    }
+  }
+
+  // not a unit period (fractional count) so use smallest unit with whole count
+  for (auto i = std::size(periods); i-- > 0; ) {
+    const char *period = periods[i];
+
+    long scale;
+
+    if (! lookupUnit(period, strlen(period), durationUnits, scale))
+      continue;
+
+    auto count = (__int128) count_*scale;
+
+    if (count % period_ == 0 && count/period_ <= std::numeric_limits<long>::max()) {
+      values.push_back(formatScaledValue(long(count/period_), countUnits, suffixes) + "/" + period);
+      return;
+    }
+  }
+
+  // decimal count per second (shortest which converts back)
+  double value = getValue();
+
+  char buffer[64];
+
+  for (int precision = 1; precision <= 18; ++precision) {
+    snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+
+    if (strtod(buffer, nullptr) == value)
+      break;
+  }
+
+  values.push_back(std::string(buffer) + "/s");
+}
+
+void
+CArgRate::
+hashValue(CArgHasher &hasher) const
+{
+  // count per period with common factors removed (10k/s == 600k/min)
+  long d = std::gcd(count_, period_);
+
+  hasher.add(d != 0 ? count_/d : count_);
+  hasher.add(d != 0 ? period_/d : period_);
+}
+
+void
+CArgRate::
 print() const
 {
   CArg::print();
 
-  std::cout << "Value    " << value_  << "\n";
-  std::cout << "Default  " << defval_ << "\n";
+  std::cout << "Value    " << count_    << "/" << period_    << "ns\n";
+  std::cout << "Default  " << defcount_ << "/" << defperiod_ << "ns\n";
 }
 
 //------
 
-CArgStringList::
-CArgStringList(const std::string &name, int flags, const std::string &defval, bool attached,
-               const std::string &desc) :
- CArg(name, CARG_TYPE_STRING, flags, attached, desc), defval_(defval)
+CArgCustom::
+CArgCustom(std::string_view name, int flags, const CArgCustomTypeP &customType,
+           std::string_view defval, bool attached, std::string_view desc) :
+ CArg(name, CARG_TYPE_CUSTOM, flags, attached, desc), customType_(customType)
 {
+  memcpy(data_, customType_->defdata.data(), CARG_CUSTOM_SIZE);
+
+  if (defval != "" && ! customType_->parse(std::string(defval).c_str(), data_)) {
+    CTHROW(std::string("Invalid ") + customType_->name);
+    return;
+  }
 }
 
 bool
-CArgStringList::
+CArgCustom::
 setValue1(const char **args, int)
 {
-  values_.push_back(args[0]);
+  // parse into temporary so value is unchanged on failure
+  alignas(std::max_align_t) unsigned char data[CARG_CUSTOM_SIZE];
+
+  memcpy(data, customType_->defdata.data(), CARG_CUSTOM_SIZE);
+
+  if (! customType_->parse(args[0], data)) {
+    setError("invalid " + customType_->name);
+    return false;
+  }
+
+  memcpy(data_, data, customType_->size);
 
   return true;
 }
 
 bool
-CArgStringList::
+CArgCustom::
 setArg1(va_list *vargs)
 {
-  std::string *value = va_arg(*vargs, std::string *);
+  void *value = va_arg(*vargs, void *);
 
   if (! value)
     return false;
 
-  if (values_.empty())
-    return false;
-
-  *value = values_[0];
+  memcpy(value, data_, customType_->size);
 
   return true;
 }
 
 void
-CArgStringList::
-print() const
+CArgCustom::
+getValueStrings(std::vector<std::string> &values) const
 {
-  CArg::print();
-
-  auto num_values = values_.size();
-
-  std::cout << "Values   ";
-
-  for (uint i = 0; i < num_values; ++i) {
-    if (i > 0)
-      std::cout << ", ";
+  // no value if type has no format proc
+  if (customType_->format)
+    values.push_back(customType_->format(data_));
+}
 
-    std::cout << values_[i];
-  }
+void
+CArgCustom::
+hashValue(CArgHasher &hasher) const
+{
+  // raw bytes (type must have no padding for equal values to hash equal)
+  hasher.add(data_, customType_->size);
+}
 
-  std::cout << "\n";
+void
+CArgCustom::
+print() const
+{
+  CArg::print();
 
-  std::cout << "Default  " << defval_ << "\n";
+  std::cout << "Custom   " << customType_->name << " (" << customType_->size << " bytes)\n";
 }
 
 //------
 
-CArgChoice::
-CArgChoice(const std::string &name, int flags, const ChoiceList &choices, long defval,
-           bool attached, const std::string &desc) :
- CArg(name, CARG_TYPE_CHOICE, flags,  attached, desc), value_(defval),
- choices_(choices), defval_(defval)
+CArgPath::
+CArgPath(std::string_view name, int flags, int checks, std::string_view defval,
+         bool attached, std::string_view desc) :
+ CArg(name, CARG_TYPE_PATH, flags, attached, desc), defval_(defval), checks_(checks)
 {
 }
 
-bool
-CArgChoice::
-setValue1(const char **args, int)
+std::string_view
+CArgPath::
+getValue() const
 {
-  long value = 0;
-
-  std::string choice = args[0];
-
-  auto pstring1 = choices_.begin();
-  auto pstring2 = choices_.end  ();
+  if (values_.empty())
+    return defval_;
 
-  for ( ; pstring1 != pstring2; ++pstring1) {
-    if (choice == *pstring1) {
-      value_ = value;
+  return values_.back();
+}
 
-      return true;
-    }
+bool
+CArgPath::
+setValue1(const char **args, int)
+{
+  // paths are checked by CArgs::checkPaths after parse
+  if (! (getFlags() & CARG_FLAG_MULTIPLE))
+    values_.clear();
 
-    value++;
-  }
+  values_.push_back(args[0]);
 
-  return false;
+  return true;
 }
 
 bool
-CArgChoice::
+CArgPath::
 setArg1(va_list *vargs)
 {
-  long *value = va_arg(*vargs, long *);
+  std::string *value = va_arg(*vargs, std::string *);
 
   if (! value)
     return false;
 
-  *value = value_;
+  *value = getValue();
 
   return true;
 }
 
 void
-CArgChoice::
+CArgPath::
+getValueStrings(std::vector<std::string> &values) const
+{
+  if (values_.empty())
+    values.push_back(std::string(defval_));
+  else {
+    for (const auto &value : values_)
+      values.push_back(value);
+  }
+}
+
+void
+CArgPath::
+hashValue(CArgHasher &hasher) const
+{
+  if (values_.empty()) {
+    hasher.add(uint64_t(1));
+
+    hasher.addString(defval_);
+  }
+  else {
+    hasher.add(uint64_t(values_.size()));
+
+    for (const auto &value : values_)
+      hasher.addString(value);
+  }
+}
+
+void
+CArgPath::
 print() const
 {
   CArg::print();
 
-  std::cout << "Value    " << value_  << "\n";
-  std::cout << "Default  " << defval_ << "\n";
+  std::cout << "Values   ";
 
-  std::cout << "Choices ";
+  auto num_values = values_.size();
 
-  auto pstring1 = choices_.begin();
-  auto pstring2 = choices_.end  ();
+  for (uint i = 0; i < num_values; ++i) {
+    if (i > 0)
+      std::cout << ", ";
 
-  for ( ; pstring1 != pstring2; ++pstring1)
-    std::cout << " " << *pstring1;
+    std::cout << values_[i];
+  }
 
   std::cout << "\n";
+
+  std::cout << "Default  " << defval_ << "\n";
 }
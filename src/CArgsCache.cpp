@@ -0,0 +1,311 @@
+#include <CArgsCache.h>
+#include <CArgsTokenizer.h>
+
+CArgsCache::
+CArgsCache(const std::string &def, size_t capacity, uint numShards) :
+ def_(def)
+{
+  // power of two shards (shard is selected by hash bits)
+  uint n = 1;
+
+  while (n < numShards)
+    n <<= 1;
+
+  shardCapacity_ = std::max((capacity + n - 1)/n, size_t(1));
+
+  for (uint i = 0; i < n; ++i)
+    shards_.emplace_back(new Shard);
+
+  updateCacheable();
+}
+
+CArgsCache::
+~CArgsCache()
+{
+}
+
+// results depend on file system if paths are checked, positionals are
+// globbed or response files are read
+void
+CArgsCache::
+updateCacheable()
+{
+  cacheable_ = false;
+
+  CArgs cargs;
+
+  try {
+    if (initProc_)
+      initProc_(cargs);
+
+    cargs.setFormat(def_);
+  }
+  catch (...) {
+    // (every parse fails)
+    return;
+  }
+
+  if (cargs.isResponseFiles() || cargs.isGlobPositionals())
+    return;
+
+  for (int id = 0; id < cargs.getNumArgs(); ++id) {
+    const CArg *arg = cargs.getArg(id);
+
+    if (arg->getType() == CARG_TYPE_PATH &&
+        static_cast<const CArgPath *>(arg)->getChecks() != CARG_PATH_CHECK_NONE)
+      return;
+  }
+
+  cacheable_ = true;
+}
+
+CArgsCache::ViewP
+CArgsCache::
+parse(int argc, const char * const *argv)
+{
+  if (argc < 1)
+    return parse1("", 0, nullptr);
+
+  std::vector<std::string_view> tokens;
+
+  tokens.reserve(size_t(argc - 1));
+
+  for (int i = 1; i < argc; ++i)
+    tokens.push_back(argv[i]);
+
+  return parse1(argv[0], tokens.size(), tokens.data());
+}
+
+CArgsCache::ViewP
+CArgsCache::
+parse(const std::vector<std::string> &args)
+{
+  if (args.empty())
+    return parse1("", 0, nullptr);
+
+  std::vector<std::string_view> tokens;
+
+  tokens.reserve(args.size() - 1);
+
+  for (size_t i = 1; i < args.size(); ++i)
+    tokens.push_back(args[i]);
+
+  return parse1(args[0].c_str(), tokens.size(), tokens.data());
+}
+
+CArgsCache::ViewP
+CArgsCache::
+parseString(const std::string &str)
+{
+  CArgsTokenizer tokenizer;
+
+  if (! tokenizer.tokenize(str, "")) {
+    std::cerr << "Error: " << tokenizer.getError() << "\n";
+    return ViewP();
+  }
+
+  return parse(tokenizer.argc(), tokenizer.argv());
+}
+
+CArgsCache::ViewP
+CArgsCache::
+parse1(const char *arg0, size_t num, const std::string_view *tokens)
+{
+  if (! cacheable_)
+    return parseTokens(arg0, num, tokens);
+
+  CArgHasher hasher;
+
+  hasher.add(uint64_t(num));
+
+  for (size_t i = 0; i < num; ++i)
+    hasher.addString(tokens[i]);
+
+  uint64_t hash = hasher.result().lo;
+
+  Shard &shard = *shards_[(hash >> 32) & (shards_.size() - 1)];
+
+  auto equalTokens = [&](const Entry &entry) {
+    if (entry.tokens.size() != num)
+      return false;
+
+    for (size_t i = 0; i < num; ++i)
+      if (entry.tokens[i] != tokens[i])
+        return false;
+
+    return true;
+  };
+
+  // lookup (move hit to front of LRU list)
+  {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+
+    auto range = shard.map.equal_range(hash);
+
+    for (auto p = range.first; p != range.second; ++p) {
+      if (! equalTokens(*p->second))
+        continue;
+
+      shard.entries.splice(shard.entries.begin(), shard.entries, p->second);
+
+      shard.hits.fetch_add(1, std::memory_order_relaxed);
+
+      return p->second->view;
+    }
+  }
+
+  shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+  //---
+
+  // parse unlocked
+  ViewP view = parseTokens(arg0, num, tokens);
+
+  if (! view)
+    return view;
+
+  //---
+
+  std::unique_lock<std::mutex> lock(shard.mutex);
+
+  // use entry added by another thread while parsing
+  auto range = shard.map.equal_range(hash);
+
+  for (auto p = range.first; p != range.second; ++p)
+    if (equalTokens(*p->second))
+      return p->second->view;
+
+  Entry entry;
+
+  entry.hash = hash;
+  entry.view = view;
+
+  entry.tokens.reserve(num);
+
+  for (size_t i = 0; i < num; ++i)
+    entry.tokens.push_back(std::string(tokens[i]));
+
+  shard.entries.push_front(std::move(entry));
+
+  shard.map.insert(EntryMap::value_type(hash, shard.entries.begin()));
+
+  // remove least recently used
+  while (shard.entries.size() > shardCapacity_) {
+    auto last = std::prev(shard.entries.end());
+
+    auto range1 = shard.map.equal_range(last->hash);
+
+    for (auto p = range1.first; p != range1.second; ++p) {
+      if (p->second == last) {
+        shard.map.erase(p);
+        break;
+      }
+    }
+
+    shard.entries.pop_back();
+  }
+
+  return view;
+}
+
+CArgsCache::ViewP
+CArgsCache::
+parseTokens(const char *arg0, size_t num, const std::string_view *tokens) const
+{
+  CArgs cargs;
+
+  try {
+    if (initProc_)
+      initProc_(cargs);
+
+    cargs.setFormat(def_);
+
+    std::vector<std::string> args;
+
+    args.reserve(num + 1);
+
+    args.push_back(arg0);
+
+    for (size_t i = 0; i < num; ++i)
+      args.push_back(std::string(tokens[i]));
+
+    if (! cargs.parse(args))
+      return ViewP();
+
+    return std::make_shared<const CArgsView>(cargs);
+  }
+  catch (...) {
+    return ViewP();
+  }
+}
+
+size_t
+CArgsCache::
+size() const
+{
+  size_t n = 0;
+
+  for (const auto &shard : shards_) {
+    std::unique_lock<std::mutex> lock(shard->mutex);
+
+    n += shard->entries.size();
+  }
+
+  return n;
+}
+
+uint64_t
+CArgsCache::
+hits() const
+{
+  uint64_t n = 0;
+
+  for (const auto &shard : shards_)
+    n += shard->hits.load(std::memory_order_relaxed);
+
+  return n;
+}
+
+uint64_t
+CArgsCache::
+misses() const
+{
+  uint64_t n = 0;
+
+  for (const auto &shard : shards_)
+    n += shard->misses.load(std::memory_order_relaxed);
+
+  return n;
+}
+
+double
+CArgsCache::
+hitRate() const
+{
+  uint64_t h = hits  ();
+  uint64_t m = misses();
+
+  return (h + m > 0 ? double(h)/double(h + m) : 0.0);
+}
+
+void
+CArgsCache::
+resetCounters()
+{
+  for (auto &shard : shards_) {
+    shard->hits  .store(0, std::memory_order_relaxed);
+    shard->misses.store(0, std::memory_order_relaxed);
+  }
+}
+
+void
+CArgsCache::
+clear()
+{
+  for (auto &shard : shards_) {
+    std::unique_lock<std::mutex> lock(shard->mutex);
+
+    shard->map    .clear();
+    shard->entries.clear();
+  }
+}
@@ -0,0 +1,903 @@
+// Generate a specialised parser (C++ header) for a CArgs format string.
+//
+//   CArgsGen [-name <struct>] [-o <file>] -- <format>|@<format file>
+//
+// The generated header defines a struct with a field (of the option's type,
+// initialized to its default) for each option and a parse method which does
+// the same as CArgs::parse for the format: option names are found by a
+// perfect hash (plus prefix tests for attached options), each option's value
+// is converted by inline code for its type and stored in its field, and
+// errors, warnings and usage text are reported in the same way. The
+// generated code does not use (or link with) libCArgs.
+//
+// Supported option types are flags, integers, reals, strings and choices
+// (with ranges, label=value choices and the n and r flags).
+
+#include <CArgs.h>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <set>
+
+namespace {
+
+struct Option {
+  const CArg *arg { nullptr };
+  int         id  { 0 };
+  std::string name;
+  std::string field;
+};
+
+typedef std::vector<Option> OptionList;
+
+// C++ string literal for string
+std::string
+literal(const std::string_view &str)
+{
+  std::string lstr = "\"";
+
+  for (auto c : str) {
+    if      (c == '"' ) lstr += "\\\"";
+    else if (c == '\\') lstr += "\\\\";
+    else if (c == '\n') lstr += "\\n";
+    else if (c == '\t') lstr += "\\t";
+    else if (isprint(static_cast<unsigned char>(c)))
+      lstr += c;
+    else {
+      char buffer[8];
+
+      snprintf(buffer, sizeof(buffer), "\\%03o", static_cast<unsigned char>(c));
+
+      lstr += buffer;
+    }
+  }
+
+  lstr += "\"";
+
+  return lstr;
+}
+
+// C++ identifier for option name
+std::string
+fieldName(const std::string_view &name)
+{
+  static const std::set<std::string> keywords = {
+    // C++ keywords and alternative tokens (C++20 ones too)
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool",
+    "break", "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class",
+    "compl", "concept", "const", "consteval", "constexpr", "constinit", "const_cast",
+    "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+    "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+    "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable",
+    "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+    "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+    "requires", "return", "short", "signed", "sizeof", "static", "static_assert",
+    "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+    "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using",
+    "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+    // standard macros
+    "NULL", "EOF", "errno", "assert", "stdin", "stdout", "stderr",
+    // names used by generated code
+    "parse", "usage", "format", "isSet", "matchOption", "flagOption", "setFlags",
+    "setValue", "foldChar", "equal", "hash", "toInteger", "toReal", "positionals_",
+    "set_", "help_", "c", "h", "i", "j", "l", "r", "id", "value", "error", "errors",
+    "opt", "len", "str", "str1", "str2", "seed", "end", "cmd", "arg", "argc", "argv",
+    "noCase", "table", "names", "lens", "next", "flag", "attachLen", "skip_remaining",
+    "found", "num_args", "all_found", "std", "NUM_ARGS" };
+
+  std::string field;
+
+  for (auto c : name) {
+    if (field.empty() && c == '-')
+      continue;
+
+    if (isalnum(static_cast<unsigned char>(c)))
+      field += c;
+    // (names containing '__' are reserved)
+    else if (field.empty() || field.back() != '_')
+      field += '_';
+  }
+
+  // (names starting with '_' are reserved)
+  if (field.empty() || isdigit(static_cast<unsigned char>(field[0])) || field[0] == '_')
+    field = "opt" + field;
+
+  if (keywords.find(field) != keywords.end())
+    field += "Arg";
+
+  return field;
+}
+
+uint64_t
+nameHash(const std::string &name, uint64_t seed)
+{
+  return CArgEnumUtil::hash(name.data(), name.size(), seed);
+}
+
+// find seed and (power of two) table size where (case folded) hashes of
+// unattached option names do not collide
+bool
+perfectHash(const OptionList &options, uint &size, uint64_t &seed)
+{
+  std::set<std::string> folded;
+
+  uint num = 0;
+
+  for (const auto &option : options) {
+    if (option.arg->getAttached())
+      continue;
+
+    std::string fname;
+
+    for (auto c : option.name)
+      fname += CArgEnumUtil::foldChar(c);
+
+    // names which only differ in case share a slot (chained)
+    if (folded.insert(fname).second)
+      ++num;
+  }
+
+  size = 1;
+
+  while (size < 2*num)
+    size <<= 1;
+
+  std::vector<char> used;
+
+  for ( ; size <= (1U<<16); size <<= 1) {
+    for (seed = 0; seed < 100000; ++seed) {
+      used.assign(size, 0);
+
+      bool ok = true;
+
+      for (const auto &fname : folded) {
+        uint slot = uint(nameHash(fname, seed) & (size - 1));
+
+        if (used[slot]) {
+          ok = false;
+          break;
+        }
+
+        used[slot] = 1;
+      }
+
+      if (ok)
+        return true;
+    }
+  }
+
+  return false;
+}
+
+std::string
+cppType(CArgType type)
+{
+  switch (type) {
+    case CARG_TYPE_BOOLEAN: return "bool";
+    case CARG_TYPE_INTEGER: return "long";
+    case CARG_TYPE_REAL   : return "double";
+    case CARG_TYPE_STRING : return "std::string";
+    case CARG_TYPE_CHOICE : return "long";
+    default               : return "";
+  }
+}
+
+std::string
+realString(double r)
+{
+  char buffer[64];
+
+  snprintf(buffer, sizeof(buffer), "%.17g", r);
+
+  std::string str = buffer;
+
+  if (str.find_first_of(".eEn") == std::string::npos)
+    str += ".0";
+
+  return str;
+}
+
+std::string
+longString(long l)
+{
+  // LONG_MIN is not a valid literal
+  if (l == std::numeric_limits<long>::min())
+    return "(-" + std::to_string(std::numeric_limits<long>::max()) + "L - 1)";
+
+  return std::to_string(l) + "L";
+}
+
+std::string
+defaultValue(const CArg *arg)
+{
+  switch (arg->getType()) {
+    case CARG_TYPE_BOOLEAN:
+      return (static_cast<const CArgBoolean *>(arg)->getValue() ? "true" : "false");
+    case CARG_TYPE_INTEGER:
+      return longString(static_cast<const CArgInteger *>(arg)->getValue());
+    case CARG_TYPE_REAL:
+      return realString(static_cast<const CArgReal *>(arg)->getValue());
+    case CARG_TYPE_STRING:
+      return literal(static_cast<const CArgString *>(arg)->getValue());
+    case CARG_TYPE_CHOICE:
+      return longString(static_cast<const CArgChoice *>(arg)->getValue());
+    default:
+      return "";
+  }
+}
+
+// usage text of CArgs (without command name)
+std::string
+usageText(const CArgs &cargs)
+{
+  std::stringstream ss;
+
+  auto *buf = std::cerr.rdbuf(ss.rdbuf());
+
+  cargs.usage("");
+
+  std::cerr.rdbuf(buf);
+
+  return ss.str();
+}
+
+//---
+
+void
+writeHeader(std::ostream &os, const CArgs &cargs, const OptionList &options,
+            const std::string &name, uint hashSize, uint64_t hashSeed)
+{
+  auto num = options.size();
+
+  std::string guard = name + "_CARGS_GEN_H";
+
+  for (auto &c : guard)
+    c = char(toupper(static_cast<unsigned char>(c)));
+
+  os << "// Generated by CArgsGen from:\n";
+  os << "//\n";
+  os << "//   " << cargs.getFormat() << "\n";
+  os << "//\n";
+  os << "// Do not edit.\n";
+  os << "\n";
+  os << "#ifndef " << guard << "\n";
+  os << "#define " << guard << "\n";
+  os << "\n";
+  os << "#include <cstdint>\n";
+  os << "#include <cstdlib>\n";
+  os << "#include <cstring>\n";
+  os << "#include <iostream>\n";
+  os << "#include <string>\n";
+  os << "#include <vector>\n";
+  os << "\n";
+
+  //---
+
+  os << "struct " << name << " {\n";
+  os << "  enum {\n";
+
+  for (const auto &option : options)
+    os << "    ARG_" << option.field << ",\n";
+
+  os << "    NUM_ARGS\n";
+  os << "  };\n";
+  os << "\n";
+
+  size_t typeLen = 0, fieldLen = 0;
+
+  for (const auto &option : options) {
+    typeLen  = std::max(typeLen , cppType(option.arg->getType()).size());
+    fieldLen = std::max(fieldLen, option.field.size());
+  }
+
+  for (const auto &option : options) {
+    std::string type = cppType(option.arg->getType());
+
+    os << "  " << type << std::string(typeLen - type.size() + 1, ' ') <<
+          option.field << std::string(fieldLen - option.field.size() + 1, ' ') <<
+          "{ " << defaultValue(option.arg) << " };\n";
+  }
+
+  if (num > 0)
+    os << "\n";
+
+  os << "  std::vector<std::string> positionals_;\n";
+  os << "  bool                     set_[NUM_ARGS > 0 ? NUM_ARGS : 1] { };\n";
+  os << "  bool                     help_ { false };\n";
+  os << "\n";
+  os << "  // parse arguments (argv[0] is program name)\n";
+  os << "  bool parse(int argc, char **argv);\n";
+  os << "\n";
+  os << "  bool isSet(int id) const { return id >= 0 && id < NUM_ARGS && set_[id]; }\n";
+  os << "\n";
+  os << "  static void usage(const char *cmd);\n";
+  os << "\n";
+  os << "  // format parser was generated from\n";
+  os << "  static const char *format() { return " << literal(cargs.getFormat()) << "; }\n";
+  os << "\n";
+  os << "  // option id for argument (-1 if none)\n";
+  os << "  static int matchOption(const char *opt, size_t len);\n";
+  os << "\n";
+  os << "  // option id of single letter flag (-1 if none)\n";
+  os << "  static int flagOption(char c);\n";
+  os << "\n";
+  os << " private:\n";
+  os << "  // set all single letter flags with letter\n";
+  os << "  void setFlags(char c);\n";
+  os << "\n";
+  os << "  bool setValue(int id, const char *value, std::string &error);\n";
+  os << "\n";
+  os << "  static char foldChar(char c) {\n";
+  os << "    return (c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c);\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  static bool equal(const char *str1, const char *str2, size_t len, bool noCase) {\n";
+  os << "    if (! noCase)\n";
+  os << "      return (memcmp(str1, str2, len) == 0);\n";
+  os << "\n";
+  os << "    for (size_t i = 0; i < len; ++i)\n";
+  os << "      if (foldChar(str1[i]) != foldChar(str2[i]))\n";
+  os << "        return false;\n";
+  os << "\n";
+  os << "    return true;\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  // case folded FNV-1a with seed and final mix (as CArgEnumUtil::hash)\n";
+  os << "  static uint64_t hash(const char *str, size_t len, uint64_t seed) {\n";
+  os << "    uint64_t h = 0xcbf29ce484222325ULL ^ (seed*0x9e3779b97f4a7c15ULL);\n";
+  os << "\n";
+  os << "    for (size_t i = 0; i < len; ++i) {\n";
+  os << "      h ^= uint8_t(foldChar(str[i]));\n";
+  os << "      h *= 0x100000001b3ULL;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL; h ^= h >> 33;\n";
+  os << "\n";
+  os << "    return h;\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  static bool toInteger(const char *str, long &l) {\n";
+  os << "    char *end;\n";
+  os << "\n";
+  os << "    l = strtol(str, &end, 10);\n";
+  os << "\n";
+  os << "    return (end != str && *end == '\\0');\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  static bool toReal(const char *str, double &r) {\n";
+  os << "    char *end;\n";
+  os << "\n";
+  os << "    r = strtod(str, &end);\n";
+  os << "\n";
+  os << "    return (end != str && *end == '\\0');\n";
+  os << "  }\n";
+  os << "};\n";
+  os << "\n";
+
+  //---
+
+  os << "inline void\n" << name << "::\nusage(const char *cmd)\n{\n";
+  os << "  std::cerr << cmd << " << literal(usageText(cargs)) << ";\n";
+  os << "}\n";
+  os << "\n";
+
+  //---
+
+  // perfect hash table of unattached names (slot -> first id) with next id
+  // of names which only differ in case (same slot)
+  std::vector<int> table(hashSize, -1), next(std::max(num, size_t(1)), -1), last(hashSize, -1);
+
+  for (const auto &option : options) {
+    if (option.arg->getAttached())
+      continue;
+
+    uint slot = uint(nameHash(option.name, hashSeed) & (hashSize - 1));
+
+    if (table[slot] < 0)
+      table[slot] = option.id;
+    else
+      next[size_t(last[slot])] = option.id;
+
+    last[slot] = option.id;
+  }
+
+  os << "inline int\n" << name << "::\nmatchOption(const char *opt, size_t len)\n{\n";
+
+  os << "  static const int table[" << hashSize << "] = {";
+
+  for (uint i = 0; i < hashSize; ++i) {
+    if (i % 16 == 0)
+      os << "\n    ";
+
+    os << table[i] << (i + 1 < hashSize ? "," : "");
+  }
+
+  os << "\n  };\n";
+  os << "\n";
+
+  os << "  static const char *const names[" << std::max(num, size_t(1)) << "] = {";
+
+  for (size_t i = 0; i < num; ++i)
+    os << "\n    " << literal(options[i].name) << (i + 1 < num ? "," : "");
+
+  if (num == 0)
+    os << " \"\"";
+
+  os << "\n  };\n";
+  os << "\n";
+
+  os << "  static const uint16_t lens[" << std::max(num, size_t(1)) << "] = {";
+
+  for (size_t i = 0; i < num; ++i)
+    os << " " << options[i].name.size() << (i + 1 < num ? "," : "");
+
+  if (num == 0)
+    os << " 0";
+
+  os << " };\n";
+  os << "\n";
+
+  os << "  static const bool noCase[" << std::max(num, size_t(1)) << "] = {";
+
+  for (size_t i = 0; i < num; ++i)
+    os << " " << ((options[i].arg->getFlags() & CARG_FLAG_NO_CASE) ? "true" : "false") <<
+          (i + 1 < num ? "," : "");
+
+  if (num == 0)
+    os << " false";
+
+  os << " };\n";
+  os << "\n";
+
+  os << "  static const int next[" << next.size() << "] = {";
+
+  for (size_t i = 0; i < next.size(); ++i)
+    os << " " << next[i] << (i + 1 < next.size() ? "," : "");
+
+  os << " };\n";
+  os << "\n";
+  os << "  int id = table[hash(opt, len, " << hashSeed << "ULL) & " << (hashSize - 1) << "];\n";
+  os << "\n";
+  os << "  while (id >= 0 && (len != lens[id] || ! equal(opt, names[id], len, noCase[id])))\n";
+  os << "    id = next[id];\n";
+
+  bool first = true;
+
+  for (const auto &option : options) {
+    if (! option.arg->getAttached())
+      continue;
+
+    if (first) {
+      os << "\n";
+      os << "  // attached options defined before match\n";
+
+      first = false;
+    }
+
+    int i = option.id;
+
+    os << "  if ((id < 0 || id > " << i << ") && len > " << option.name.size() <<
+          " && equal(opt, names[" << i << "], " << option.name.size() << ", noCase[" << i <<
+          "]))\n";
+    os << "    return " << i << ";\n";
+  }
+
+  os << "\n";
+  os << "  return id;\n";
+  os << "}\n";
+  os << "\n";
+
+  //---
+
+  os << "inline int\n" << name << "::\nflagOption(char c)\n{\n";
+
+  std::set<char> letters;
+
+  for (const auto &option : options) {
+    if (option.arg->getType() == CARG_TYPE_BOOLEAN && option.name.size() == 2 &&
+        letters.insert(option.name[1]).second)
+      os << "  if (c == '" << option.name[1] << "') return " << option.id << ";\n";
+  }
+
+  if (letters.empty())
+    os << "  (void) c;\n";
+
+  os << "\n";
+  os << "  return -1;\n";
+  os << "}\n";
+  os << "\n";
+
+  // (duplicate letters all set)
+  os << "inline void\n" << name << "::\nsetFlags(char c)\n{\n";
+
+  for (const auto &option : options) {
+    if (option.arg->getType() == CARG_TYPE_BOOLEAN && option.name.size() == 2)
+      os << "  if (c == '" << option.name[1] << "') { " << option.field << " = true; " <<
+            "set_[ARG_" << option.field << "] = true; }\n";
+  }
+
+  if (letters.empty())
+    os << "  (void) c;\n";
+
+  os << "}\n";
+  os << "\n";
+
+  //---
+
+  os << "inline bool\n" << name << "::\nsetValue(int id, const char *value, std::string &error)\n{\n";
+  os << "  switch (id) {\n";
+
+  for (const auto &option : options) {
+    const CArg *arg = option.arg;
+
+    const std::string &field = option.field;
+
+    CArgType type = arg->getType();
+
+    os << "    case ARG_" << field << ": {\n";
+
+    if      (type == CARG_TYPE_BOOLEAN) {
+      os << "      " << field << " = true;\n";
+    }
+    else if (type == CARG_TYPE_INTEGER) {
+      auto *iarg = static_cast<const CArgInteger *>(arg);
+
+      os << "      long l;\n";
+      os << "\n";
+      os << "      if (! toInteger(value, l))\n";
+      os << "        return false;\n";
+      os << "\n";
+
+      if (iarg->getMin() != std::numeric_limits<long>::min() ||
+          iarg->getMax() != std::numeric_limits<long>::max()) {
+        std::string msg = "out of range [" + std::to_string(iarg->getMin()) + "," +
+                          std::to_string(iarg->getMax()) + "]";
+
+        os << "      if (l < " << longString(iarg->getMin()) << " || l > " <<
+              longString(iarg->getMax()) << ") {\n";
+        os << "        error = " << literal(msg) << ";\n";
+        os << "        return false;\n";
+        os << "      }\n";
+        os << "\n";
+      }
+
+      os << "      " << field << " = l;\n";
+    }
+    else if (type == CARG_TYPE_REAL) {
+      auto *rarg = static_cast<const CArgReal *>(arg);
+
+      os << "      double r;\n";
+      os << "\n";
+      os << "      if (! toReal(value, r))\n";
+      os << "        return false;\n";
+      os << "\n";
+
+      if (rarg->getMin() != -std::numeric_limits<double>::max() ||
+          rarg->getMax() !=  std::numeric_limits<double>::max()) {
+        std::string msg = "out of range [" + std::to_string(rarg->getMin()) + "," +
+                          std::to_string(rarg->getMax()) + "]";
+
+        os << "      if (r < " << realString(rarg->getMin()) << " || r > " <<
+              realString(rarg->getMax()) << ") {\n";
+        os << "        error = " << literal(msg) << ";\n";
+        os << "        return false;\n";
+        os << "      }\n";
+        os << "\n";
+      }
+
+      os << "      " << field << " = r;\n";
+    }
+    else if (type == CARG_TYPE_STRING) {
+      os << "      " << field << " = value;\n";
+    }
+    else if (type == CARG_TYPE_CHOICE) {
+      auto *carg = static_cast<const CArgChoice *>(arg);
+
+      bool noCase = (arg->getFlags() & CARG_FLAG_NO_CASE);
+
+      const auto &choices = carg->getChoices();
+      const auto &values  = carg->getValues ();
+
+      os << "      size_t len = strlen(value);\n";
+      os << "\n";
+
+      // first of duplicate choices is used
+      std::set<std::string> seen;
+
+      for (size_t i = 0; i < choices.size(); ++i) {
+        std::string choice(choices[i]);
+
+        std::string key = choice;
+
+        if (noCase)
+          for (auto &c : key)
+            c = CArgEnumUtil::foldChar(c);
+
+        if (! seen.insert(key).second)
+          continue;
+
+        os << "      if (len == " << choice.size() << " && equal(value, " << literal(choice) <<
+              ", len, " << (noCase ? "true" : "false") << ")) { " << field << " = " <<
+              longString(values[i]) << "; return true; }\n";
+      }
+
+      os << "\n";
+      os << "      return false;\n";
+      os << "    }\n";
+
+      continue;
+    }
+
+    os << "\n";
+    os << "      return true;\n";
+    os << "    }\n";
+  }
+
+  os << "    default:\n";
+  os << "      break;\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  (void) value; (void) error;\n";
+  os << "\n";
+  os << "  return false;\n";
+  os << "}\n";
+  os << "\n";
+
+  //---
+
+  os << "inline bool\n" << name << "::\nparse(int argc, char **argv)\n{\n";
+  os << "  *this = " << name << "();\n";
+  os << "\n";
+  os << "  std::vector<std::string> errors;\n";
+  os << "\n";
+  // name length of attached options (value follows name)
+  os << "  static const uint16_t attachLen[" << std::max(num, size_t(1)) << "] = {";
+
+  for (size_t i = 0; i < num; ++i)
+    os << " " << (options[i].arg->getAttached() ? options[i].name.size() : 0) <<
+          (i + 1 < num ? "," : "");
+
+  if (num == 0)
+    os << " 0";
+
+  os << " };\n";
+  os << "\n";
+  os << "  static const bool flag[" << std::max(num, size_t(1)) << "] = {";
+
+  for (size_t i = 0; i < num; ++i)
+    os << " " << (options[i].arg->getType() == CARG_TYPE_BOOLEAN ? "true" : "false") <<
+          (i + 1 < num ? "," : "");
+
+  if (num == 0)
+    os << " false";
+
+  os << " };\n";
+  os << "\n";
+  os << "  bool skip_remaining = false;\n";
+  os << "\n";
+  os << "  int i = 1;\n";
+  os << "\n";
+  os << "  while (i < argc) {\n";
+  os << "    const char *arg = argv[i];\n";
+  os << "\n";
+  os << "    if (arg[0] != '-' || skip_remaining) {\n";
+  os << "      positionals_.push_back(arg);\n";
+  os << "      ++i;\n";
+  os << "      continue;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    if (strcmp(arg, \"--\") == 0) {\n";
+  os << "      skip_remaining = true;\n";
+  os << "      ++i;\n";
+  os << "      continue;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    if (strcmp(arg, \"--help\") == 0) {\n";
+  os << "      usage(argv[0]);\n";
+  os << "      help_ = true;\n";
+  os << "      ++i;\n";
+  os << "      continue;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    size_t len = strlen(arg);\n";
+  os << "\n";
+  os << "    int id = matchOption(arg, len);\n";
+  os << "\n";
+  os << "    if (id < 0) {\n";
+
+  if (letters.empty()) {
+    os << "      std::cerr << \"Warning: Unrecognised argument \" << arg << \"\\n\";\n";
+  }
+  else {
+    os << "      // combined single letter flags (all must be known)\n";
+    os << "      bool found = (len > 1);\n";
+    os << "\n";
+    os << "      for (size_t j = 1; found && j < len; ++j) {\n";
+    os << "        if (flagOption(arg[j]) < 0) {\n";
+    os << "          std::cerr << \"Warning: Unrecognised argument -\" << arg[j] << \"\\n\";\n";
+    os << "          found = false;\n";
+    os << "        }\n";
+    os << "      }\n";
+    os << "\n";
+    os << "      for (size_t j = 1; found && j < len; ++j)\n";
+    os << "        setFlags(arg[j]);\n";
+  }
+
+  os << "\n";
+  os << "      ++i;\n";
+  os << "      continue;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    int num_args = (attachLen[id] || flag[id] ? 0 : 1);\n";
+  os << "\n";
+  os << "    if (i + num_args >= argc) {\n";
+  os << "      errors.push_back(std::string(\"Missing Value for \") + arg);\n";
+  os << "      break;\n";
+  os << "    }\n";
+  os << "\n";
+  os << "    ++i;\n";
+  os << "\n";
+  os << "    const char *value = (attachLen[id] ? arg + attachLen[id] : (num_args ? argv[i] : \"\"));\n";
+  os << "\n";
+  os << "    std::string error;\n";
+  os << "\n";
+  os << "    set_[id] = setValue(id, value, error);\n";
+  os << "\n";
+  os << "    // (attached value reported for option name, as CArgs)\n";
+  os << "    if (! set_[id])\n";
+  os << "      errors.push_back(std::string(\"Invalid Value \") + value + \" for \" +\n";
+  os << "                       (attachLen[id] ? std::string(arg, attachLen[id]) : std::string(arg)) +\n";
+  os << "                       (error != \"\" ? \" (\" + error + \")\" : \"\"));\n";
+  os << "\n";
+  os << "    i += num_args;\n";
+  os << "  }\n";
+  os << "\n";
+  os << "  for (const auto &error : errors)\n";
+  os << "    std::cerr << \"Error: \" << error << \"\\n\";\n";
+  os << "\n";
+  os << "  bool all_found = true;\n";
+
+  for (const auto &option : options) {
+    if (! option.arg->getRequired())
+      continue;
+
+    os << "\n";
+    os << "  if (! set_[ARG_" << option.field << "]) {\n";
+    os << "    std::cerr << \"Required argument " << option.name << " not supplied\\n\";\n";
+    os << "    all_found = false;\n";
+    os << "  }\n";
+  }
+
+  os << "\n";
+  os << "  if (! all_found)\n";
+  os << "    return false;\n";
+  os << "\n";
+  os << "  return errors.empty();\n";
+  os << "}\n";
+  os << "\n";
+  os << "#endif\n";
+}
+
+}
+
+//------
+
+int
+main(int argc, char **argv)
+{
+  CArgs cargs("-name:s=CArgsParser (struct name) -o:s (output file)");
+
+  if (! cargs.parse(&argc, argv))
+    exit(1);
+
+  if (cargs.isHelp())
+    exit(0);
+
+  const auto &positionals = cargs.getPositionals();
+
+  if (positionals.size() != 1) {
+    std::cerr << "Usage: CArgsGen [-name <struct>] [-o <file>] -- <format>|@<format file>\n";
+    exit(1);
+  }
+
+  std::string format = positionals[0];
+
+  if (format.size() > 1 && format[0] == '@') {
+    std::ifstream file(format.substr(1));
+
+    if (! file) {
+      std::cerr << "Failed to read " << format.substr(1) << "\n";
+      exit(1);
+    }
+
+    std::stringstream ss;
+
+    ss << file.rdbuf();
+
+    format = ss.str();
+
+    // one line (options may be on separate lines)
+    for (auto &c : format)
+      if (c == '\n' || c == '\r')
+        c = ' ';
+  }
+
+  //---
+
+  CArgs spec;
+
+  try {
+    spec.setFormat(format);
+  }
+  catch (const std::exception &e) {
+    std::cerr << "Invalid format: " << e.what() << "\n";
+    exit(1);
+  }
+
+  std::string name = cargs.getStringArg("-name");
+
+  OptionList options;
+
+  // (struct name is its constructor)
+  std::set<std::string> fields { name };
+
+  for (int id = 0; id < spec.getNumArgs(); ++id) {
+    const CArg *arg = spec.getArg(id);
+
+    Option option;
+
+    option.arg   = arg;
+    option.id    = id;
+    option.name  = arg->getName();
+    option.field = fieldName(option.name);
+
+    CArgType type = arg->getType();
+
+    bool supported = (cppType(type) != "");
+
+    if (type == CARG_TYPE_STRING &&
+        (dynamic_cast<const CArgStringList *>(arg) ||
+         static_cast<const CArgString *>(arg)->hasPattern()))
+      supported = false;
+
+    if (! supported) {
+      std::cerr << "Unsupported option " << option.name << "\n";
+      exit(1);
+    }
+
+    // unique field name
+    std::string field = option.field;
+
+    for (int n = 2; ! fields.insert(option.field).second; ++n)
+      option.field = field + std::to_string(n);
+
+    options.push_back(option);
+  }
+
+  uint     hashSize = 1;
+  uint64_t hashSeed = 0;
+
+  if (! perfectHash(options, hashSize, hashSeed)) {
+    std::cerr << "Failed to find perfect hash\n";
+    exit(1);
+  }
+
+  //---
+
+  std::string filename = cargs.getStringArg("-o");
+
+  if (filename != "") {
+    std::ofstream os(filename);
+
+    if (! os) {
+      std::cerr << "Failed to write " << filename << "\n";
+      exit(1);
+    }
+
+    writeHeader(os, spec, options, name, hashSize, hashSeed);
+  }
+  else
+    writeHeader(std::cout, spec, options, name, hashSize, hashSeed);
+
+  return 0;
+}
@@ -0,0 +1,285 @@
+#include <CArgsGlob.h>
+#include <algorithm>
+#include <cstring>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+
+namespace {
+
+// path split into components
+struct GlobPattern {
+  std::string              prefix;     // literal leading directory ("" or ends in '/')
+  std::vector<std::string> components; // remaining components (first has wildcard)
+  bool                     dirOnly { false }; // trailing '/' (only match directories)
+  CArgsGlob::StringList    matches;
+};
+
+// read directory 'dir' (prefix of result path) for component 'comp' of 'pattern'
+struct GlobTask {
+  size_t      pattern { 0 };
+  std::string dir;
+  size_t      comp    { 0 };
+};
+
+bool
+isDir(const std::string &path, const struct dirent *entry)
+{
+  if (entry && entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK)
+    return (entry->d_type == DT_DIR);
+
+  struct stat st;
+
+  return (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode));
+}
+
+// remove backslash escapes from literal path component
+std::string
+unescape(const std::string &str)
+{
+  std::string str1;
+
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] == '\\' && i + 1 < str.size())
+      ++i;
+
+    str1 += str[i];
+  }
+
+  return str1;
+}
+
+// process task, adding sub directory tasks to 'tasks' and matches to 'matches'
+void
+processTask(const GlobPattern &pattern, const GlobTask &task,
+            std::vector<GlobTask> &tasks, CArgsGlob::StringList &matches)
+{
+  const std::string &comp = pattern.components[task.comp];
+
+  bool last = (task.comp + 1 == pattern.components.size());
+
+  auto addPath = [&](const std::string &path, const struct dirent *entry) {
+    if (last) {
+      if      (! pattern.dirOnly)
+        matches.push_back(path);
+      else if (isDir(path, entry))
+        matches.push_back(path + "/");
+    }
+    else if (isDir(path, entry)) {
+      GlobTask task1;
+
+      task1.pattern = task.pattern;
+      task1.dir     = path + "/";
+      task1.comp    = task.comp + 1;
+
+      tasks.push_back(task1);
+    }
+  };
+
+  // literal component, no need to read directory
+  if (! CArgsGlob::isPattern(comp)) {
+    std::string path = task.dir + unescape(comp);
+
+    struct stat st;
+
+    if (lstat(path.c_str(), &st) == 0)
+      addPath(path, nullptr);
+
+    return;
+  }
+
+  DIR *dir = opendir(task.dir != "" ? task.dir.c_str() : ".");
+
+  if (! dir)
+    return;
+
+  // entries are streamed (only matches are kept)
+  while (struct dirent *entry = readdir(dir)) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+      continue;
+
+    if (fnmatch(comp.c_str(), entry->d_name, FNM_PERIOD) != 0)
+      continue;
+
+    addPath(task.dir + entry->d_name, entry);
+  }
+
+  closedir(dir);
+}
+
+}
+
+bool
+CArgsGlob::
+isPattern(const std::string &str)
+{
+  // unescaped wildcard
+  for (size_t i = 0; i < str.size(); ++i) {
+    if      (str[i] == '\\')
+      ++i;
+    else if (str[i] == '*' || str[i] == '?' || str[i] == '[')
+      return true;
+  }
+
+  return false;
+}
+
+void
+CArgsGlob::
+expand(const StringList &patterns, StringList &results, int numThreads)
+{
+  std::vector<GlobPattern> globPatterns;
+  std::vector<GlobTask>    tasks;
+
+  globPatterns.resize(patterns.size());
+
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    const std::string &str = patterns[i];
+
+    if (! isPattern(str))
+      continue;
+
+    GlobPattern &pattern = globPatterns[i];
+
+    // split into literal prefix directory and components
+    std::vector<std::string> components;
+
+    size_t pos = 0;
+
+    while (pos <= str.size()) {
+      auto pos1 = str.find('/', pos);
+
+      if (pos1 == std::string::npos)
+        pos1 = str.size();
+
+      if (pos1 > pos || pos == 0)
+        components.push_back(str.substr(pos, pos1 - pos));
+
+      pos = pos1 + 1;
+    }
+
+    size_t j = 0;
+
+    while (j < components.size() && ! isPattern(components[j])) {
+      pattern.prefix += unescape(components[j]) + "/";
+
+      ++j;
+    }
+
+    pattern.components.assign(components.begin() + long(j), components.end());
+
+    pattern.dirOnly = (str.size() > 1 && str.back() == '/');
+
+    if (pattern.components.empty())
+      continue;
+
+    GlobTask task;
+
+    task.pattern = i;
+    task.dir     = pattern.prefix;
+    task.comp    = 0;
+
+    tasks.push_back(task);
+  }
+
+  //---
+
+  if (! tasks.empty()) {
+    if (numThreads <= 0)
+      numThreads = int(std::min(64U, 4*std::max(1U, std::thread::hardware_concurrency())));
+
+    std::mutex               mutex;
+    std::condition_variable  cond;
+    int                      active = 0;
+    std::vector<std::thread> threads;
+    std::function<void ()>   worker;
+
+    // add threads (up to numThreads) while there are more tasks than idle
+    // workers (so a few patterns do not start a full pool)
+    auto addThreads = [&]() {
+      while (int(threads.size()) + 1 < numThreads &&
+             tasks.size() > threads.size() + 1 - size_t(active))
+        threads.emplace_back(worker);
+    };
+
+    worker = [&]() {
+      std::vector<GlobTask> tasks1;
+      StringList            matches1;
+
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (true) {
+        cond.wait(lock, [&]() { return ! tasks.empty() || active == 0; });
+
+        if (tasks.empty())
+          break;
+
+        // depth first (last added) keeps pending task list small
+        GlobTask task = std::move(tasks.back());
+
+        tasks.pop_back();
+
+        ++active;
+
+        lock.unlock();
+
+        processTask(globPatterns[task.pattern], task, tasks1, matches1);
+
+        lock.lock();
+
+        --active;
+
+        for (auto &task1 : tasks1)
+          tasks.push_back(std::move(task1));
+
+        StringList &matches = globPatterns[task.pattern].matches;
+
+        for (auto &match : matches1)
+          matches.push_back(std::move(match));
+
+        tasks1  .clear();
+        matches1.clear();
+
+        addThreads();
+
+        cond.notify_all();
+      }
+
+      cond.notify_all();
+    };
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      addThreads();
+    }
+
+    worker();
+
+    // no threads are added once all tasks are done
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  //---
+
+  for (size_t i = 0; i < patterns.size(); ++i) {
+    StringList &matches = globPatterns[i].matches;
+
+    if (matches.empty()) {
+      results.push_back(patterns[i]);
+      continue;
+    }
+
+    std::sort(matches.begin(), matches.end());
+
+    for (auto &match : matches)
+      results.push_back(std::move(match));
+
+    StringList().swap(matches);
+  }
+}
@@ -0,0 +1,359 @@
+#include <CArgsLayers.h>
+#include <CThrow.h>
+#include <cctype>
+
+CArgsLayers::
+CArgsLayers(const std::string &def, const InitProc &initProc) :
+ def_(def), initProc_(initProc)
+{
+  if (initProc_)
+    initProc_(spec_);
+
+  spec_.setFormat(def_);
+
+  numArgs_ = spec_.getNumArgs();
+
+  for (int id = 0; id < numArgs_; ++id)
+    types_.push_back(spec_.getArg(id)->getType());
+
+  setLayer(LAYER_DEFAULTS, spec_);
+}
+
+const char *
+CArgsLayers::
+layerName(Layer layer)
+{
+  switch (layer) {
+    case LAYER_DEFAULTS: return "defaults";
+    case LAYER_CONFIG  : return "config";
+    case LAYER_ENV     : return "env";
+    case LAYER_ARGV    : return "argv";
+    default            : return "";
+  }
+}
+
+void
+CArgsLayers::
+setLayer(Layer layer, const CArgs &cargs)
+{
+  if (layer < 0 || layer >= NUM_LAYERS) {
+    CTHROW("Invalid layer");
+    return;
+  }
+
+  if (cargs.getNumArgs() != numArgs_ || cargs.getFormat() != spec_.getFormat()) {
+    CTHROW(std::string("Layer ") + layerName(layer) + " has different options");
+    return;
+  }
+
+  LayerData &data = layers_[layer];
+
+  size_t num_words = (size_t(numArgs_) + 63)/64;
+
+  data.bits  .assign(num_words, 0);
+  data.ranks .assign(num_words, 0);
+  data.values.clear();
+
+  data.positionals = cargs.getPositionals();
+
+  for (int id = 0; id < numArgs_; ++id) {
+    const CArg *arg = cargs.getArg(id);
+
+    if (layer != LAYER_DEFAULTS && ! arg->getSet())
+      continue;
+
+    data.bits[size_t(id)/64] |= (uint64_t(1) << (id % 64));
+
+    data.values.emplace_back();
+
+    getValue(arg, data.values.back());
+  }
+
+  uint32_t rank = 0;
+
+  for (size_t i = 0; i < num_words; ++i) {
+    data.ranks[i] = rank;
+
+    rank += uint32_t(__builtin_popcountll(data.bits[i]));
+  }
+}
+
+void
+CArgsLayers::
+clearLayer(Layer layer)
+{
+  if (layer <= LAYER_DEFAULTS || layer >= NUM_LAYERS)
+    return;
+
+  LayerData &data = layers_[layer];
+
+  data.bits  .clear();
+  data.ranks .clear();
+  data.values.clear();
+
+  data.positionals.clear();
+}
+
+void
+CArgsLayers::
+getValue(const CArg *arg, Value &value)
+{
+  switch (arg->getType()) {
+    case CARG_TYPE_BOOLEAN:
+      value.value = static_cast<const CArgBoolean *>(arg)->getValue();
+      break;
+    case CARG_TYPE_INTEGER:
+      value.value = static_cast<const CArgInteger *>(arg)->getValue();
+      break;
+    case CARG_TYPE_REAL: {
+      double r = static_cast<const CArgReal *>(arg)->getValue();
+
+      memcpy(&value.value, &r, sizeof(r));
+
+      break;
+    }
+    case CARG_TYPE_STRING: {
+      if (auto *larg = dynamic_cast<const CArgStringList *>(arg))
+        value.strs = larg->getValue();
+      else
+        value.str = static_cast<const CArgString *>(arg)->getValue();
+
+      break;
+    }
+    case CARG_TYPE_CHOICE:
+      value.value = static_cast<const CArgChoice *>(arg)->getValue();
+      break;
+    case CARG_TYPE_SIZE:
+      value.value = static_cast<const CArgSize *>(arg)->getValue();
+      break;
+    case CARG_TYPE_DURATION:
+      value.value = static_cast<const CArgDuration *>(arg)->getValue();
+      break;
+    case CARG_TYPE_RATE: {
+      auto *rarg = static_cast<const CArgRate *>(arg);
+
+      value.value  = rarg->getCount();
+      value.value2 = rarg->getPeriod();
+
+      break;
+    }
+    case CARG_TYPE_CUSTOM: {
+      auto *carg = static_cast<const CArgCustom *>(arg);
+
+      value.str.assign(static_cast<const char *>(carg->getData()), carg->getCustomType().size);
+
+      break;
+    }
+    case CARG_TYPE_PATH: {
+      auto *parg = static_cast<const CArgPath *>(arg);
+
+      if (parg->getValues().empty())
+        value.strs.push_back(std::string(parg->getValue()));
+      else
+        value.strs = parg->getValues();
+
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+//---
+
+bool
+CArgsLayers::
+parseLayer(Layer layer, std::vector<std::string> &args, bool responseFiles)
+{
+  CArgs cargs;
+
+  if (initProc_)
+    initProc_(cargs);
+
+  cargs.setFormat(def_);
+
+  cargs.setResponseFiles(responseFiles);
+
+  // required options can be set by another layer (see checkRequired)
+  cargs.setRequiredChecked(false);
+
+  if (! cargs.parse(args))
+    return false;
+
+  setLayer(layer, cargs);
+
+  return true;
+}
+
+bool
+CArgsLayers::
+parseConfig(const std::string &filename)
+{
+  std::vector<std::string> args { "", "@" + filename };
+
+  return parseLayer(LAYER_CONFIG, args, /*responseFiles*/true);
+}
+
+bool
+CArgsLayers::
+parseEnv(const std::string &prefix)
+{
+  std::vector<std::string> args { "" };
+
+  std::string envName;
+
+  for (int id = 0; id < numArgs_; ++id) {
+    const CArg *arg = spec_.getArg(id);
+
+    std::string_view name = arg->getNameView();
+
+    envName = prefix;
+
+    for (size_t i = (name.size() > 0 && name[0] == '-' ? 1 : 0); i < name.size(); ++i) {
+      int c = static_cast<unsigned char>(name[i]);
+
+      envName += (isalnum(c) ? char(toupper(c)) : '_');
+    }
+
+    const char *env = getenv(envName.c_str());
+
+    if (! env)
+      continue;
+
+    if (types_[size_t(id)] == CARG_TYPE_BOOLEAN) {
+      if (strcmp(env, "") != 0 && strcmp(env, "0") != 0 && strcmp(env, "false") != 0)
+        args.push_back(std::string(name));
+
+      continue;
+    }
+
+    if (arg->getAttached())
+      args.push_back(std::string(name) + env);
+    else {
+      args.push_back(std::string(name));
+      args.push_back(env);
+    }
+  }
+
+  return parseLayer(LAYER_ENV, args);
+}
+
+bool
+CArgsLayers::
+parseArgv(int argc, char **argv, bool responseFiles)
+{
+  std::vector<std::string> args;
+
+  for (int i = 0; i < argc; ++i)
+    args.push_back(argv[i]);
+
+  return parseLayer(LAYER_ARGV, args, responseFiles);
+}
+
+bool
+CArgsLayers::
+checkRequired() const
+{
+  bool all_found = true;
+
+  for (int id = 0; id < numArgs_; ++id) {
+    const CArg *arg = spec_.getArg(id);
+
+    if (arg->getRequired() && ! isSet(id)) {
+      std::cerr << "Required argument " << arg->getNameView() << " not supplied\n";
+      all_found = false;
+    }
+  }
+
+  return all_found;
+}
+
+//---
+
+CArgsLayers::Layer
+CArgsLayers::
+getLayer(int id) const
+{
+  if (id < 0 || id >= numArgs_)
+    return LAYER_DEFAULTS;
+
+  size_t   word = size_t(id)/64;
+  uint64_t mask = uint64_t(1) << (id % 64);
+
+  for (int l = NUM_LAYERS - 1; l > LAYER_DEFAULTS; --l) {
+    const LayerData &data = layers_[l];
+
+    if (word < data.bits.size() && (data.bits[word] & mask))
+      return Layer(l);
+  }
+
+  return LAYER_DEFAULTS;
+}
+
+const CArgsLayers::Value &
+CArgsLayers::
+value(int id, CArgType type) const
+{
+  static Value noValue;
+
+  if (id < 0 || id >= numArgs_) {
+    CTHROW("Invalid option id " + std::to_string(id));
+    return noValue;
+  }
+
+  if (types_[size_t(id)] != type) {
+    CTHROW("Option " + spec_.getArg(id)->getName() + " has wrong type");
+    return noValue;
+  }
+
+  const LayerData &data = layers_[getLayer(id)];
+
+  // rank of bit in layer
+  size_t   word = size_t(id)/64;
+  uint64_t mask = uint64_t(1) << (id % 64);
+
+  size_t rank = data.ranks[word] + size_t(__builtin_popcountll(data.bits[word] & (mask - 1)));
+
+  return data.values[rank];
+}
+
+double
+CArgsLayers::
+getReal(int id) const
+{
+  double r;
+
+  memcpy(&r, &value(id, CARG_TYPE_REAL).value, sizeof(r));
+
+  return r;
+}
+
+double
+CArgsLayers::
+getRate(int id) const
+{
+  const Value &v = value(id, CARG_TYPE_RATE);
+
+  return (v.value2 != 0 ? 1E9*double(v.value)/double(v.value2) : 0.0);
+}
+
+std::string_view
+CArgsLayers::
+getString(int id) const
+{
+  // last path value
+  if (id >= 0 && id < numArgs_ && types_[size_t(id)] == CARG_TYPE_PATH) {
+    const Value &v = value(id, CARG_TYPE_PATH);
+
+    return (! v.strs.empty() ? std::string_view(v.strs.back()) : std::string_view());
+  }
+
+  return value(id, CARG_TYPE_STRING).str;
+}
+
+const CArgsLayers::StringList &
+CArgsLayers::
+getStringList(int id) const
+{
+  return value(id, CARG_TYPE_STRING).strs;
+}
@@ -0,0 +1,68 @@
+#include <CArgsRegistry.h>
+#include <algorithm>
+
+// section bounds defined by the linker (weak so there can be no entries)
+extern "C" {
+extern const CArgsSpecEntry __start_cargs_spec[] __attribute__((weak));
+extern const CArgsSpecEntry __stop_cargs_spec [] __attribute__((weak));
+}
+
+const CArgsRegistry::EntryList &
+CArgsRegistry::
+entries()
+{
+  static EntryList entries = []() {
+    EntryList entries1;
+
+    if (__start_cargs_spec) {
+      for (const CArgsSpecEntry *e = __start_cargs_spec; e < __stop_cargs_spec; ++e)
+        entries1.push_back(e);
+    }
+
+    // (stable so equal entries, e.g. from a header in several files, keep
+    // section order)
+    std::stable_sort(entries1.begin(), entries1.end(),
+      [](const CArgsSpecEntry *e1, const CArgsSpecEntry *e2) {
+        int cmp = strcmp(e1->file, e2->file);
+
+        if (cmp != 0) return (cmp < 0);
+
+        if (e1->line != e2->line) return (e1->line < e2->line);
+
+        return (e1->counter < e2->counter);
+      });
+
+    return entries1;
+  }();
+
+  return entries;
+}
+
+const std::string &
+CArgsRegistry::
+spec()
+{
+  static std::string spec = []() {
+    std::string spec1;
+
+    for (const auto *e : entries()) {
+      if (! spec1.empty())
+        spec1 += " ";
+
+      spec1 += e->spec;
+    }
+
+    return spec1;
+  }();
+
+  return spec;
+}
+
+CArgs &
+CArgsRegistry::
+args()
+{
+  static CArgs args(spec());
+
+  return args;
+}
@@ -0,0 +1,139 @@
+#include <CArgsTokenizer.h>
+#include <cstring>
+
+bool
+CArgsTokenizer::
+tokenize(const char *str, size_t len, const char *arg0)
+{
+  error_.clear();
+
+  argv_.clear();
+
+  if (arg0)
+    argv_.push_back(const_cast<char *>(arg0));
+
+  buffer_.resize(len + 1);
+
+  if (len)
+    memcpy(&buffer_[0], str, len);
+
+  buffer_[len] = '\0';
+
+  // words are unescaped in place: 'w' (write) never passes 'r' (read)
+  char *buffer = &buffer_[0];
+
+  char *r   = buffer;
+  char *w   = buffer;
+  char *end = buffer + len;
+
+  auto isSpace = [](char c) {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v');
+  };
+
+  bool ok = true;
+
+  while (r < end) {
+    while (r < end && isSpace(*r))
+      ++r;
+
+    if (r >= end)
+      break;
+
+    if (*r == '#') {
+      while (r < end && *r != '\n')
+        ++r;
+
+      continue;
+    }
+
+    // word starting at w (may be empty e.g. '')
+    char *word = w;
+
+    bool inWord = false;
+
+    while (r < end && ! isSpace(*r)) {
+      char c = *r++;
+
+      if      (c == '\'') {
+        while (r < end && *r != '\'')
+          *w++ = *r++;
+
+        if (r >= end) {
+          error_ = "Unterminated ' quote";
+          ok     = false;
+          break;
+        }
+
+        ++r;
+
+        inWord = true;
+      }
+      else if (c == '"') {
+        while (r < end && *r != '"') {
+          if (*r == '\\' && r + 1 < end && strchr("$`\"\\\n", r[1])) {
+            ++r;
+
+            // line continuation
+            if (*r == '\n') {
+              ++r;
+              continue;
+            }
+          }
+
+          *w++ = *r++;
+        }
+
+        if (r >= end) {
+          error_ = "Unterminated \" quote";
+          ok     = false;
+          break;
+        }
+
+        ++r;
+
+        inWord = true;
+      }
+      else if (c == '\\') {
+        if (r >= end) {
+          // trailing backslash is literal
+          *w++ = c;
+
+          inWord = true;
+        }
+        else if (*r == '\n') {
+          // line continuation
+          ++r;
+        }
+        else {
+          *w++ = *r++;
+
+          inWord = true;
+        }
+      }
+      else {
+        *w++ = c;
+
+        inWord = true;
+      }
+    }
+
+    if (! ok)
+      break;
+
+    // a line continuation on its own is not a word
+    if (! inWord)
+      continue;
+
+    // skip separator then terminate word (w is now before r)
+    if (r < end)
+      ++r;
+
+    *w++ = '\0';
+
+    argv_.push_back(word);
+  }
+
+  argv_.push_back(nullptr);
+
+  return ok;
+}
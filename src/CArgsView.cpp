@@ -0,0 +1,1020 @@
+#include <CArgsView.h>
+#include <CArgvBuilder.h>
+#include <CThrow.h>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t CARGS_VIEW_MAGIC   = 0x56524143; // "CARV"
+const uint16_t CARGS_VIEW_VERSION = 3;
+
+// hash of format string (FNV-1a)
+uint64_t
+formatHash(const std::string &str)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+
+  for (auto c : str) {
+    h ^= uint8_t(c);
+    h *= 0x100000001b3ULL;
+  }
+
+  return h;
+}
+
+// case folded name hash (so no case options can be found)
+uint32_t
+nameHash(const std::string_view &name)
+{
+  return uint32_t(CArgEnumUtil::hash(name.data(), name.size(), 0));
+}
+
+bool
+nameMatch(const std::string_view &name1, const std::string_view &name2, bool no_case)
+{
+  if (name1.size() != name2.size())
+    return false;
+
+  if (! no_case)
+    return (name1 == name2);
+
+  for (size_t i = 0; i < name1.size(); ++i)
+    if (CArgEnumUtil::foldChar(name1[i]) != CArgEnumUtil::foldChar(name2[i]))
+      return false;
+
+  return true;
+}
+
+// append only byte buffer used to lay out view data
+class Writer {
+ public:
+  size_t size() const { return data_.size(); }
+
+  void align(size_t n) {
+    data_.resize((data_.size() + n - 1) & ~(n - 1));
+  }
+
+  size_t reserve(size_t n, size_t alignment=8) {
+    align(alignment);
+
+    size_t pos = data_.size();
+
+    data_.resize(pos + n);
+
+    return pos;
+  }
+
+  template<typename T> T *at(size_t pos) {
+    return reinterpret_cast<T *>(&data_[pos]);
+  }
+
+  // null terminated string
+  size_t addString(const std::string_view &str) {
+    size_t pos = data_.size();
+
+    data_.insert(data_.end(), str.begin(), str.end());
+    data_.push_back('\0');
+
+    return pos;
+  }
+
+  size_t addBytes(const void *bytes, size_t n) {
+    size_t pos = reserve(n, 16);
+
+    if (n > 0)
+      memcpy(&data_[pos], bytes, n);
+
+    return pos;
+  }
+
+  const std::vector<char> &data() const { return data_; }
+
+ private:
+  std::vector<char> data_;
+};
+
+}
+
+//---
+
+CArgsView::
+CArgsView(const CArgs &cargs)
+{
+  build(cargs);
+}
+
+CArgsView::
+CArgsView(const void *data, size_t size)
+{
+  std::string error;
+
+  if (! validate(data, size, error)) {
+    CTHROW("Invalid view data: " + error);
+
+    build(CArgs());
+
+    return;
+  }
+
+  char *data1 = static_cast<char *>(aligned_alloc(64, (size + 63) & ~size_t(63)));
+
+  memcpy(data1, data, size);
+
+  data_ = data1;
+  size_ = size;
+
+  init();
+}
+
+CArgsView::
+CArgsView(const char *data, size_t size, Mapped) :
+ data_(data), size_(size), mapped_(true)
+{
+  init();
+}
+
+void
+CArgsView::
+build(const CArgs &cargs)
+{
+  int num_options     = cargs.getNumArgs();
+  int num_positionals = int(cargs.getPositionals().size());
+
+  uint32_t hashSize = 1;
+
+  while (hashSize < 2*uint32_t(num_options))
+    hashSize <<= 1;
+
+  // per option arrays have at least one entry (so bad ids are safe)
+  size_t n = size_t(std::max(num_options, 1));
+
+  Writer writer;
+
+  size_t headerPos = writer.reserve(sizeof(Header));
+
+  // hot
+  size_t valuesPos     = writer.reserve(n*sizeof(int64_t), 64);
+  size_t values2Pos    = writer.reserve(n*sizeof(int64_t));
+  size_t valueHashPos  = writer.reserve(n*sizeof(uint64_t));
+  size_t nameHashesPos = writer.reserve(n*sizeof(uint32_t));
+  size_t typesPos      = writer.reserve(n*sizeof(uint8_t));
+  size_t flagsPos      = writer.reserve(n*sizeof(uint8_t));
+  size_t hashPos       = writer.reserve(hashSize*sizeof(int32_t));
+
+  // cold
+  size_t namesPos       = writer.reserve(n*sizeof(StrRef), 64);
+  size_t descsPos       = writer.reserve(n*sizeof(StrRef));
+  size_t textsPos       = writer.reserve(n*sizeof(StrRef));
+  size_t positionalsPos = writer.reserve(size_t(num_positionals)*sizeof(StrRef));
+
+  writer.align(8);
+
+  size_t stringsPos = writer.size();
+
+  auto addStr = [&](const std::string_view &str) {
+    StrRef ref;
+
+    ref.len    = uint32_t(str.size());
+    ref.offset = uint32_t(writer.addString(str));
+
+    return ref;
+  };
+
+  auto addStrList = [&](const std::vector<std::string> &strs, int64_t &v0, int64_t &v1) {
+    std::vector<StrRef> refs;
+
+    for (const auto &str : strs)
+      refs.push_back(addStr(str));
+
+    v0 = int64_t(writer.addBytes(refs.data(), refs.size()*sizeof(StrRef)));
+    v1 = int64_t(refs.size());
+  };
+
+  std::vector<std::string> valueStrs;
+
+  std::string text;
+
+  // sum of option fingerprints (as CArgs::getFingerprint but always from the
+  // current values so it agrees with the value hashes)
+  CArgFingerprint fingerprint;
+
+  for (int id = 0; id < num_options; ++id) {
+    const CArg *arg = cargs.getArg(id);
+
+    int64_t v0 = 0, v1 = 0;
+
+    uint8_t flags = 0;
+
+    if (arg->getSet     ()) flags |= FLAG_SET;
+    if (arg->getAttached()) flags |= FLAG_ATTACHED;
+
+    if (arg->getFlags() & CARG_FLAG_NO_CASE) flags |= FLAG_NO_CASE;
+
+    switch (arg->getType()) {
+      case CARG_TYPE_BOOLEAN:
+        v0 = static_cast<const CArgBoolean *>(arg)->getValue();
+        break;
+      case CARG_TYPE_INTEGER:
+        v0 = static_cast<const CArgInteger *>(arg)->getValue();
+        break;
+      case CARG_TYPE_REAL: {
+        double r = static_cast<const CArgReal *>(arg)->getValue();
+
+        memcpy(&v0, &r, sizeof(r));
+
+        break;
+      }
+      case CARG_TYPE_STRING: {
+        if (auto *larg = dynamic_cast<const CArgStringList *>(arg)) {
+          flags |= FLAG_LIST;
+
+          addStrList(larg->getValue(), v0, v1);
+        }
+        else {
+          StrRef ref = addStr(static_cast<const CArgString *>(arg)->getValue());
+
+          v0 = ref.offset;
+          v1 = ref.len;
+        }
+
+        break;
+      }
+      case CARG_TYPE_CHOICE:
+        v0 = static_cast<const CArgChoice *>(arg)->getValue();
+        break;
+      case CARG_TYPE_SIZE:
+        v0 = static_cast<const CArgSize *>(arg)->getValue();
+        break;
+      case CARG_TYPE_DURATION:
+        v0 = static_cast<const CArgDuration *>(arg)->getValue();
+        break;
+      case CARG_TYPE_RATE: {
+        auto *rarg = static_cast<const CArgRate *>(arg);
+
+        v0 = rarg->getCount();
+        v1 = rarg->getPeriod();
+
+        break;
+      }
+      case CARG_TYPE_CUSTOM: {
+        auto *carg = static_cast<const CArgCustom *>(arg);
+
+        v1 = int64_t(carg->getCustomType().size);
+        v0 = int64_t(writer.addBytes(carg->getData(), size_t(v1)));
+
+        break;
+      }
+      case CARG_TYPE_PATH: {
+        // list of values (default if none set)
+        auto *parg = static_cast<const CArgPath *>(arg);
+
+        flags |= FLAG_LIST;
+
+        if (parg->getValues().empty())
+          addStrList(std::vector<std::string>({std::string(parg->getValue())}), v0, v1);
+        else
+          addStrList(parg->getValues(), v0, v1);
+
+        break;
+      }
+      default:
+        break;
+    }
+
+    CArgFingerprint argFingerprint = cargs.getArgFingerprint(id);
+
+    fingerprint.lo += argFingerprint.lo;
+    fingerprint.hi += argFingerprint.hi;
+
+    writer.at<int64_t >(valuesPos    )[id] = v0;
+    writer.at<int64_t >(values2Pos   )[id] = v1;
+    writer.at<uint64_t>(valueHashPos )[id] = argFingerprint.lo;
+    writer.at<uint32_t>(nameHashesPos)[id] = nameHash(arg->getNameView());
+    writer.at<uint8_t >(typesPos     )[id] = uint8_t(arg->getType());
+    writer.at<uint8_t >(flagsPos     )[id] = flags;
+
+    StrRef name = addStr(arg->getNameView());
+    StrRef desc = addStr(arg->getDescView());
+
+    // value strings (quoted, space separated)
+    valueStrs.clear();
+
+    arg->getValueStrings(valueStrs);
+
+    text.clear();
+
+    for (const auto &valueStr : valueStrs) {
+      if (! text.empty())
+        text += ' ';
+
+      CArgvBuilder::quote(valueStr, text);
+    }
+
+    StrRef valueText = addStr(text);
+
+    writer.at<StrRef>(namesPos)[id] = name;
+    writer.at<StrRef>(descsPos)[id] = desc;
+    writer.at<StrRef>(textsPos)[id] = valueText;
+  }
+
+  //---
+
+  // hash of name to id (linear probe)
+  auto *hash = writer.at<int32_t>(hashPos);
+
+  for (uint32_t i = 0; i < hashSize; ++i)
+    hash[i] = -1;
+
+  for (int id = 0; id < num_options; ++id) {
+    uint32_t h = writer.at<uint32_t>(nameHashesPos)[id] & (hashSize - 1);
+
+    while (hash[h] >= 0)
+      h = (h + 1) & (hashSize - 1);
+
+    hash[h] = id;
+  }
+
+  //---
+
+  int i = 0;
+
+  for (const auto &positional : cargs.getPositionals()) {
+    StrRef ref = addStr(positional);
+
+    writer.at<StrRef>(positionalsPos)[i] = ref;
+
+    ++i;
+  }
+
+  writer.align(64);
+
+  //---
+
+  Header *header = writer.at<Header>(headerPos);
+
+  header->magic             = CARGS_VIEW_MAGIC;
+  header->version           = CARGS_VIEW_VERSION;
+  header->headerSize        = sizeof(Header);
+  header->size              = uint32_t(writer.size());
+  header->numOptions        = uint32_t(num_options);
+  header->numPositionals    = uint32_t(num_positionals);
+  header->hashSize          = hashSize;
+  header->specHash          = formatHash(cargs.getFormat());
+  header->fingerprintLo     = fingerprint.lo;
+  header->fingerprintHi     = fingerprint.hi;
+  header->valuesOffset      = uint32_t(valuesPos);
+  header->values2Offset     = uint32_t(values2Pos);
+  header->valueHashesOffset = uint32_t(valueHashPos);
+  header->nameHashesOffset  = uint32_t(nameHashesPos);
+  header->typesOffset       = uint32_t(typesPos);
+  header->flagsOffset       = uint32_t(flagsPos);
+  header->hashOffset        = uint32_t(hashPos);
+  header->namesOffset       = uint32_t(namesPos);
+  header->descsOffset       = uint32_t(descsPos);
+  header->textsOffset       = uint32_t(textsPos);
+  header->positionalsOffset = uint32_t(positionalsPos);
+  header->stringsOffset     = uint32_t(stringsPos);
+
+  //---
+
+  char *data = static_cast<char *>(aligned_alloc(64, writer.size()));
+
+  memcpy(data, writer.data().data(), writer.size());
+
+  data_ = data;
+  size_ = writer.size();
+
+  init();
+}
+
+// check header, section bounds and every string/data reference is inside the
+// data so a view of (untrusted) data cannot read outside it
+bool
+CArgsView::
+validate(const void *data, size_t size, std::string &error)
+{
+  auto fail = [&](const char *msg) { error = msg; return false; };
+
+  const char *bytes = static_cast<const char *>(data);
+
+  if (size < sizeof(Header))
+    return fail("too small");
+
+  Header header;
+
+  memcpy(&header, bytes, sizeof(Header));
+
+  if (header.magic != CARGS_VIEW_MAGIC)
+    return fail("bad magic");
+
+  if (header.version != CARGS_VIEW_VERSION)
+    return fail("unsupported version");
+
+  if (header.headerSize != sizeof(Header) || header.size != size)
+    return fail("bad size");
+
+  uint64_t n  = std::max(header.numOptions, 1U);
+  uint64_t np = header.numPositionals;
+
+  // section is inside data and aligned for its type
+  auto checkSection = [&](uint32_t offset, uint64_t len, size_t alignment) {
+    return (offset >= sizeof(Header) && offset + len <= size && offset % alignment == 0);
+  };
+
+  if (! checkSection(header.valuesOffset     , n*sizeof(int64_t)       , 8) ||
+      ! checkSection(header.values2Offset    , n*sizeof(int64_t)       , 8) ||
+      ! checkSection(header.valueHashesOffset, n*sizeof(uint64_t)      , 8) ||
+      ! checkSection(header.nameHashesOffset , n*sizeof(uint32_t)      , 4) ||
+      ! checkSection(header.typesOffset      , n*sizeof(uint8_t)       , 1) ||
+      ! checkSection(header.flagsOffset      , n*sizeof(uint8_t)       , 1) ||
+      ! checkSection(header.namesOffset      , n*sizeof(StrRef)        , 4) ||
+      ! checkSection(header.descsOffset      , n*sizeof(StrRef)        , 4) ||
+      ! checkSection(header.textsOffset      , n*sizeof(StrRef)        , 4) ||
+      ! checkSection(header.positionalsOffset, np*sizeof(StrRef)       , 4) ||
+      ! checkSection(header.hashOffset       , header.hashSize*uint64_t(sizeof(int32_t)), 4) ||
+      header.stringsOffset > size)
+    return fail("bad section");
+
+  // hash table must have a free slot (to end probe)
+  if (header.hashSize == 0 || (header.hashSize & (header.hashSize - 1)) != 0 ||
+      header.hashSize <= header.numOptions)
+    return fail("bad hash size");
+
+  auto checkRef = [&](const char *p) {
+    StrRef ref;
+
+    memcpy(&ref, p, sizeof(StrRef));
+
+    return (uint64_t(ref.offset) + ref.len <= size);
+  };
+
+  auto checkList = [&](int64_t offset, int64_t count) {
+    if (offset < 0 || count < 0 || offset % 4 != 0 ||
+        uint64_t(offset) + uint64_t(count)*sizeof(StrRef) > size)
+      return false;
+
+    for (int64_t i = 0; i < count; ++i)
+      if (! checkRef(bytes + offset + i*int64_t(sizeof(StrRef))))
+        return false;
+
+    return true;
+  };
+
+  for (uint32_t id = 0; id < header.numOptions; ++id) {
+    int64_t v0, v1;
+
+    memcpy(&v0, bytes + header.valuesOffset  + id*sizeof(int64_t), sizeof(int64_t));
+    memcpy(&v1, bytes + header.values2Offset + id*sizeof(int64_t), sizeof(int64_t));
+
+    uint8_t type  = uint8_t(bytes[header.typesOffset + id]);
+    uint8_t flags = uint8_t(bytes[header.flagsOffset + id]);
+
+    if (! checkRef(bytes + header.namesOffset + id*sizeof(StrRef)) ||
+        ! checkRef(bytes + header.descsOffset + id*sizeof(StrRef)) ||
+        ! checkRef(bytes + header.textsOffset + id*sizeof(StrRef)))
+      return fail("bad name");
+
+    if (type > CARG_TYPE_PATH)
+      return fail("bad type");
+
+    bool ok = true;
+
+    if      (flags & FLAG_LIST)
+      ok = ((type == CARG_TYPE_STRING || type == CARG_TYPE_PATH) && checkList(v0, v1));
+    else if (type == CARG_TYPE_STRING)
+      ok = (v0 >= 0 && v1 >= 0 && uint64_t(v0) + uint64_t(v1) <= size);
+    else if (type == CARG_TYPE_CUSTOM)
+      ok = (v0 >= 0 && v1 >= 0 && v1 <= CARG_CUSTOM_SIZE && uint64_t(v0) + uint64_t(v1) <= size);
+    else if (type == CARG_TYPE_PATH)
+      ok = false;
+    else if (type == CARG_TYPE_RATE)
+      ok = (v1 != 0);
+
+    if (! ok)
+      return fail("bad value");
+  }
+
+  // each id at most once (so there are free slots to end a probe)
+  std::vector<bool> used(header.numOptions);
+
+  for (uint32_t i = 0; i < header.hashSize; ++i) {
+    int32_t id;
+
+    memcpy(&id, bytes + header.hashOffset + i*sizeof(int32_t), sizeof(int32_t));
+
+    if (id == -1)
+      continue;
+
+    if (id < -1 || id >= int32_t(header.numOptions) || used[size_t(id)])
+      return fail("bad hash");
+
+    used[size_t(id)] = true;
+  }
+
+  if (! checkList(header.positionalsOffset, np))
+    return fail("bad positional");
+
+  return true;
+}
+
+namespace {
+
+const char *base64Chars =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+}
+
+std::string
+CArgsView::
+toString() const
+{
+  std::string str;
+
+  str.reserve(4*((size_ + 2)/3));
+
+  const auto *bytes = reinterpret_cast<const unsigned char *>(data_);
+
+  for (size_t i = 0; i < size_; i += 3) {
+    uint32_t v = uint32_t(bytes[i]) << 16;
+
+    if (i + 1 < size_) v |= uint32_t(bytes[i + 1]) << 8;
+    if (i + 2 < size_) v |= uint32_t(bytes[i + 2]);
+
+    str += base64Chars[(v >> 18) & 0x3f];
+    str += base64Chars[(v >> 12) & 0x3f];
+    str += (i + 1 < size_ ? base64Chars[(v >> 6) & 0x3f] : '=');
+    str += (i + 2 < size_ ? base64Chars[ v       & 0x3f] : '=');
+  }
+
+  return str;
+}
+
+std::unique_ptr<CArgsView>
+CArgsView::
+fromString(const std::string_view &str)
+{
+  if (str.size() % 4 != 0)
+    return std::unique_ptr<CArgsView>();
+
+  auto decode = [](char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+
+  std::vector<char> data;
+
+  data.reserve(3*(str.size()/4));
+
+  for (size_t i = 0; i < str.size(); i += 4) {
+    uint32_t v = 0;
+
+    int num_pad = 0;
+
+    for (size_t j = 0; j < 4; ++j) {
+      int d = 0;
+
+      if (str[i + j] == '=' && i + 4 == str.size() && j >= 2)
+        ++num_pad;
+      else if (num_pad > 0 || (d = decode(str[i + j])) < 0)
+        return std::unique_ptr<CArgsView>();
+
+      v = (v << 6) | uint32_t(d);
+    }
+
+    data.push_back(char(v >> 16));
+
+    if (num_pad < 2) data.push_back(char(v >> 8));
+    if (num_pad < 1) data.push_back(char(v));
+  }
+
+  // truncated or changed text is rejected (not reported)
+  std::string error;
+
+  if (! validate(data.data(), data.size(), error))
+    return std::unique_ptr<CArgsView>();
+
+  return std::make_unique<CArgsView>(data.data(), data.size());
+}
+
+int
+CArgsView::
+createShared(const std::string &name) const
+{
+  int fd = -1;
+
+  bool seal = (name.empty() || name[0] != '/');
+
+  if (seal)
+    fd = memfd_create(name.empty() ? "cargs" : name.c_str(), MFD_ALLOW_SEALING);
+  else
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+  if (fd < 0)
+    return -1;
+
+  // write all data (then prevent any change for memfd)
+  bool ok = (ftruncate(fd, off_t(size_)) == 0);
+
+  for (size_t pos = 0; ok && pos < size_; ) {
+    auto n = pwrite(fd, data_ + pos, size_ - pos, off_t(pos));
+
+    if      (n > 0)
+      pos += size_t(n);
+    else if (n < 0 && errno == EINTR)
+      continue;
+    else
+      ok = false;
+  }
+
+  if (ok && seal)
+    ok = (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == 0);
+
+  // named object is returned read only (creator can not change data)
+  if (ok && ! seal) {
+    int fd1 = shm_open(name.c_str(), O_RDONLY, 0);
+
+    close(fd);
+
+    fd = fd1;
+
+    ok = (fd >= 0);
+  }
+
+  if (! ok) {
+    if (! seal)
+      shm_unlink(name.c_str());
+
+    if (fd >= 0)
+      close(fd);
+
+    return -1;
+  }
+
+  return fd;
+}
+
+std::unique_ptr<CArgsView>
+CArgsView::
+mapShared(int fd)
+{
+  struct stat st;
+
+  if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    return std::unique_ptr<CArgsView>();
+
+  auto size = size_t(st.st_size);
+
+  void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+
+  if (p == MAP_FAILED)
+    return std::unique_ptr<CArgsView>();
+
+  std::string error;
+
+  // data which can still be written (not a write sealed memfd) could change
+  // after it is validated, so a copy is validated and used
+  int seals = fcntl(fd, F_GET_SEALS);
+
+  if (seals < 0 || ! (seals & F_SEAL_WRITE)) {
+    std::vector<char> data(static_cast<const char *>(p), static_cast<const char *>(p) + size);
+
+    munmap(p, size);
+
+    if (! validate(data.data(), size, error))
+      return std::unique_ptr<CArgsView>();
+
+    return std::make_unique<CArgsView>(data.data(), size);
+  }
+
+  if (! validate(p, size, error)) {
+    munmap(p, size);
+    return std::unique_ptr<CArgsView>();
+  }
+
+  return std::unique_ptr<CArgsView>(new CArgsView(static_cast<const char *>(p), size, Mapped()));
+}
+
+std::unique_ptr<CArgsView>
+CArgsView::
+openShared(const std::string &name)
+{
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+
+  if (fd < 0)
+    return std::unique_ptr<CArgsView>();
+
+  auto view = mapShared(fd);
+
+  // mapping stays valid after close
+  close(fd);
+
+  return view;
+}
+
+CArgsView::
+~CArgsView()
+{
+  if (mapped_)
+    munmap(const_cast<char *>(data_), size_);
+  else
+    free(const_cast<char *>(data_));
+}
+
+// set section pointers from header offsets
+void
+CArgsView::
+init()
+{
+  header_ = reinterpret_cast<const Header *>(data_);
+
+  numOptions_ = int(header_->numOptions);
+
+  values_      = reinterpret_cast<const int64_t  *>(data_ + header_->valuesOffset);
+  values2_     = reinterpret_cast<const int64_t  *>(data_ + header_->values2Offset);
+  valueHashes_ = reinterpret_cast<const uint64_t *>(data_ + header_->valueHashesOffset);
+  nameHashes_  = reinterpret_cast<const uint32_t *>(data_ + header_->nameHashesOffset);
+  types_       = reinterpret_cast<const uint8_t  *>(data_ + header_->typesOffset);
+  flags_       = reinterpret_cast<const uint8_t  *>(data_ + header_->flagsOffset);
+  hash_        = reinterpret_cast<const int32_t  *>(data_ + header_->hashOffset);
+  names_       = reinterpret_cast<const StrRef   *>(data_ + header_->namesOffset);
+  descs_       = reinterpret_cast<const StrRef   *>(data_ + header_->descsOffset);
+  texts_       = reinterpret_cast<const StrRef   *>(data_ + header_->textsOffset);
+  positionals_ = reinterpret_cast<const StrRef   *>(data_ + header_->positionalsOffset);
+}
+
+int
+CArgsView::
+lookup(const std::string_view &name) const
+{
+  uint32_t mask = header_->hashSize - 1;
+
+  uint32_t nh = nameHash(name);
+
+  // (probe is bounded even though validated table always has a free slot)
+  uint32_t i = nh & mask;
+
+  for (uint32_t n = 0; n <= mask && hash_[i] >= 0; ++n, i = (i + 1) & mask) {
+    int id = hash_[i];
+
+    if (nameHashes_[id] == nh && nameMatch(str(names_[id]), name, flags_[id] & FLAG_NO_CASE))
+      return id;
+  }
+
+  return -1;
+}
+
+int
+CArgsView::
+lookupName(const std::string_view &name, CArgType type) const
+{
+  int id = lookup(name);
+
+  if (id < 0 || types_[id] != type) {
+    CTHROW(std::string("Option ") + std::string(name) + std::string(" is not of requested type"));
+    return -1;
+  }
+
+  return id;
+}
+
+int
+CArgsView::
+badId(int id) const
+{
+  CTHROW(std::string("Invalid option id ") + std::to_string(id));
+
+  return 0;
+}
+
+int64_t
+CArgsView::
+badValue(int id, CArgType) const
+{
+  if (id < 0 || id >= numOptions_)
+    badId(id);
+  else
+    CTHROW(std::string("Option ") + std::string(getName(id)) +
+           std::string(" is not of requested type"));
+
+  return 0;
+}
+
+double
+CArgsView::
+getReal(int id) const
+{
+  int64_t v = value(id, CARG_TYPE_REAL);
+
+  double r;
+
+  memcpy(&r, &v, sizeof(r));
+
+  return r;
+}
+
+double
+CArgsView::
+getRate(int id) const
+{
+  int64_t count = value(id, CARG_TYPE_RATE);
+
+  return 1E9*double(count)/double(values2_[id]);
+}
+
+std::string_view
+CArgsView::
+getString(int id) const
+{
+  CArgType type = getType(id);
+
+  if (type != CARG_TYPE_STRING && type != CARG_TYPE_PATH)
+    return (badValue(id, CARG_TYPE_STRING), std::string_view());
+
+  if (flags_[id] & FLAG_LIST) {
+    if (values2_[id] == 0)
+      return std::string_view();
+
+    return str(strList(id)[values2_[id] - 1]);
+  }
+
+  StrRef ref;
+
+  ref.offset = uint32_t(values_ [id]);
+  ref.len    = uint32_t(values2_[id]);
+
+  return str(ref);
+}
+
+int
+CArgsView::
+getStringListSize(int id) const
+{
+  if (! (flags_[checkId(id)] & FLAG_LIST))
+    return int(badValue(id, CARG_TYPE_STRING));
+
+  return int(values2_[id]);
+}
+
+std::string_view
+CArgsView::
+getStringListValue(int id, int i) const
+{
+  if (! (flags_[checkId(id)] & FLAG_LIST) || i < 0 || i >= int(values2_[id]))
+    return (badValue(id, CARG_TYPE_STRING), std::string_view());
+
+  return str(strList(id)[i]);
+}
+
+std::string_view
+CArgsView::
+getPositional(int i) const
+{
+  if (i < 0 || i >= numPositionals())
+    return std::string_view();
+
+  return str(positionals_[i]);
+}
+
+bool
+CArgsView::
+diff(const CArgsView &oldView, const CArgsView &newView, Changes &changes)
+{
+  changes.clear();
+
+  if (oldView.specHash() != newView.specHash() ||
+      oldView.numOptions() != newView.numOptions()) {
+    CTHROW("Views have different option specs");
+    return false;
+  }
+
+  if (oldView.fingerprint() == newView.fingerprint())
+    return true;
+
+  // value hashes include option id and set flag (so equal hash is unchanged)
+  const int blockSize = 8;
+
+  int num_options = oldView.numOptions();
+
+  for (int id1 = 0; id1 < num_options; id1 += blockSize) {
+    int id2 = std::min(id1 + blockSize, num_options);
+
+    if (memcmp(oldView.valueHashes_ + id1, newView.valueHashes_ + id1,
+               size_t(id2 - id1)*sizeof(uint64_t)) == 0)
+      continue;
+
+    for (int id = id1; id < id2; ++id) {
+      if (oldView.valueHashes_[id] == newView.valueHashes_[id])
+        continue;
+
+      Change change;
+
+      change.id       = id;
+      change.oldSet   = oldView.isSet(id);
+      change.newSet   = newView.isSet(id);
+      change.oldValue = oldView.getValueText(id);
+      change.newValue = newView.getValueText(id);
+
+      changes.push_back(change);
+    }
+  }
+
+  return true;
+}
+
+void
+CArgsView::
+printMemory(std::ostream &os) const
+{
+  size_t n = size_t(std::max(numOptions_, 1));
+
+  size_t hot  = n*(2*sizeof(int64_t) + sizeof(uint64_t) + sizeof(uint32_t) + 2*sizeof(uint8_t));
+  size_t hash = header_->hashSize*sizeof(int32_t);
+  size_t cold = n*3*sizeof(StrRef) + size_t(numPositionals())*sizeof(StrRef);
+  size_t data = size_ - header_->stringsOffset;
+
+  auto print = [&](const char *name, size_t bytes) {
+    os << name << " " << bytes << " bytes";
+
+    if (numOptions_ > 0)
+      os << " (" << double(bytes)/numOptions_ << " per option)";
+
+    os << "\n";
+  };
+
+  os << "Options " << numOptions_ << "\n";
+
+  print("Hot     ", hot);
+  print("Hash    ", hash);
+  print("Cold    ", cold);
+  print("Strings ", data);
+  print("Total   ", size_);
+}
+
+//---
+
+bool
+CArgsView::
+getBooleanArg(const std::string_view &name) const
+{
+  return getBoolean(lookupName(name, CARG_TYPE_BOOLEAN));
+}
+
+long
+CArgsView::
+getIntegerArg(const std::string_view &name) const
+{
+  return getInteger(lookupName(name, CARG_TYPE_INTEGER));
+}
+
+double
+CArgsView::
+getRealArg(const std::string_view &name) const
+{
+  return getReal(lookupName(name, CARG_TYPE_REAL));
+}
+
+std::string_view
+CArgsView::
+getStringArg(const std::string_view &name) const
+{
+  int id = lookup(name);
+
+  return getString(id >= 0 ? id : lookupName(name, CARG_TYPE_STRING));
+}
+
+long
+CArgsView::
+getChoiceArg(const std::string_view &name) const
+{
+  return getChoice(lookupName(name, CARG_TYPE_CHOICE));
+}
+
+long
+CArgsView::
+getSizeArg(const std::string_view &name) const
+{
+  return getSize(lookupName(name, CARG_TYPE_SIZE));
+}
+
+long
+CArgsView::
+getDurationArg(const std::string_view &name) const
+{
+  return getDuration(lookupName(name, CARG_TYPE_DURATION));
+}
+
+double
+CArgsView::
+getRateArg(const std::string_view &name) const
+{
+  return getRate(lookupName(name, CARG_TYPE_RATE));
+}
@@ -0,0 +1,231 @@
+#include <CArgsWatcher.h>
+#include <cstring>
+#include <climits>
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+CArgsWatcher::
+CArgsWatcher(const std::string &def, const std::string &filename) :
+ def_(def), filename_(filename)
+{
+}
+
+CArgsWatcher::
+~CArgsWatcher()
+{
+  stop();
+
+  // no snapshots should remain
+  for (auto &retired : retired_)
+    delete retired.first;
+
+  delete current_.load();
+}
+
+bool
+CArgsWatcher::
+start()
+{
+  if (! reload())
+    return false;
+
+  // watch directory so files replaced by rename are seen
+  std::string dir = ".";
+
+  auto pos = filename_.rfind('/');
+
+  if (pos != std::string::npos)
+    dir = (pos > 0 ? filename_.substr(0, pos) : "/");
+
+  notifyFd_ = inotify_init1(IN_CLOEXEC);
+
+  if (notifyFd_ < 0)
+    return false;
+
+  // file is complete when closed after write or renamed into place (not on
+  // create, when it is still empty or partly written)
+  if (inotify_add_watch(notifyFd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+      pipe(stopFd_) != 0) {
+    close(notifyFd_);
+
+    notifyFd_ = -1;
+
+    return false;
+  }
+
+  thread_ = std::thread(&CArgsWatcher::watchLoop, this);
+
+  return true;
+}
+
+void
+CArgsWatcher::
+stop()
+{
+  // thread uses this so must be joined (write to our own pipe can only be
+  // interrupted)
+  if (thread_.joinable()) {
+    char c = 0;
+
+    while (write(stopFd_[1], &c, 1) != 1 && errno == EINTR)
+      ;
+
+    thread_.join();
+  }
+
+  for (auto &fd : stopFd_) {
+    if (fd >= 0)
+      close(fd);
+
+    fd = -1;
+  }
+
+  if (notifyFd_ >= 0)
+    close(notifyFd_);
+
+  notifyFd_ = -1;
+}
+
+void
+CArgsWatcher::
+watchLoop()
+{
+  std::string basename = filename_.substr(filename_.rfind('/') + 1);
+
+  alignas(struct inotify_event) char buffer[4096];
+
+  while (true) {
+    struct pollfd fds[2];
+
+    fds[0].fd     = notifyFd_;
+    fds[0].events = POLLIN;
+    fds[1].fd     = stopFd_[0];
+    fds[1].events = POLLIN;
+
+    if (poll(fds, 2, -1) < 0)
+      continue;
+
+    if (fds[1].revents)
+      break;
+
+    ssize_t len = read(notifyFd_, buffer, sizeof(buffer));
+
+    if (len <= 0)
+      continue;
+
+    bool changed = false;
+
+    for (ssize_t i = 0; i < len; ) {
+      auto *event = reinterpret_cast<struct inotify_event *>(&buffer[i]);
+
+      if (event->len > 0 && basename == event->name)
+        changed = true;
+
+      i += ssize_t(sizeof(struct inotify_event) + event->len);
+    }
+
+    if (changed)
+      reload();
+  }
+}
+
+bool
+CArgsWatcher::
+reload()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // parse file as response file into new CArgs
+  auto *cargs = new CArgs;
+
+  try {
+    if (initProc_)
+      initProc_(*cargs);
+
+    cargs->setFormat(def_);
+
+    cargs->setResponseFiles(true);
+
+    std::vector<std::string> args { "", "@" + filename_ };
+
+    if (! cargs->parse(args)) {
+      delete cargs;
+      return false;
+    }
+  }
+  catch (...) {
+    delete cargs;
+    return false;
+  }
+
+  // publish and retire old (reclaimed when no reader has an older epoch)
+  const CArgs *old = current_.exchange(cargs);
+
+  uint64_t epoch = epoch_.fetch_add(1) + 1;
+
+  if (old)
+    retired_.push_back(Retired(old, epoch));
+
+  ++generation_;
+
+  reclaim();
+
+  lock.unlock();
+
+  if (changedProc_)
+    changedProc_(*cargs);
+
+  return true;
+}
+
+// delete retired CArgs which no active snapshot can reference
+void
+CArgsWatcher::
+reclaim()
+{
+  uint64_t minEpoch = UINT64_MAX;
+
+  for (const auto &slot : slots_) {
+    uint64_t epoch = slot.epoch.load();
+
+    if (epoch != 0)
+      minEpoch = std::min(minEpoch, epoch);
+  }
+
+  auto p = retired_.begin();
+
+  while (p != retired_.end()) {
+    if ((*p).second <= minEpoch) {
+      delete (*p).first;
+
+      p = retired_.erase(p);
+    }
+    else
+      ++p;
+  }
+}
+
+CArgsWatcher::Snapshot
+CArgsWatcher::
+snapshot() const
+{
+  // announce epoch in a free slot (start at slot for this thread to avoid
+  // contention) then read current pointer
+  static std::atomic<uint32_t> nextThread { 0 };
+
+  thread_local uint32_t threadSlot = nextThread++;
+
+  uint64_t epoch = epoch_.load();
+
+  for (uint32_t i = threadSlot; ; ++i) {
+    auto &slot = slots_[i % NUM_SLOTS].epoch;
+
+    uint64_t expected = 0;
+
+    if (slot.load(std::memory_order_relaxed) == 0 &&
+        slot.compare_exchange_strong(expected, epoch))
+      return Snapshot(&slot, current_.load());
+  }
+}
@@ -0,0 +1,445 @@
+#include <CArgvBuilder.h>
+#include <CArgs.h>
+#include <CThrow.h>
+#include <unistd.h>
+
+extern char **environ;
+
+CArgvBuilder::
+CArgvBuilder(const CArgs &cargs, const std::string &prog) :
+ cargs_(cargs), prog_(prog), argMax_(defaultArgMax())
+{
+}
+
+CArgvBuilder::
+~CArgvBuilder()
+{
+  if (! keepSpillFile_)
+    removeSpillFile();
+}
+
+size_t
+CArgvBuilder::
+defaultArgMax()
+{
+  long arg_max = sysconf(_SC_ARG_MAX);
+
+  if (arg_max <= 0)
+    arg_max = 128*1024;
+
+  // environment shares the limit (with margin for changes in child)
+  size_t env_size = 0;
+
+  for (char **env = environ; env && *env; ++env)
+    env_size += strlen(*env) + 1 + sizeof(char *);
+
+  size_t margin = 4096;
+
+  if (size_t(arg_max) <= env_size + 2*margin)
+    return margin;
+
+  return size_t(arg_max) - env_size - margin;
+}
+
+void
+CArgvBuilder::
+setOption(const std::string &name, const std::string &value)
+{
+  setOption(name, StringList({value}));
+}
+
+void
+CArgvBuilder::
+setOption(const std::string &name, const StringList &values)
+{
+  for (auto &override : overrides_) {
+    if (override.name == name) {
+      override.remove = false;
+      override.values = values;
+      return;
+    }
+  }
+
+  Override override;
+
+  override.name   = name;
+  override.values = values;
+
+  overrides_.push_back(override);
+}
+
+void
+CArgvBuilder::
+removeOption(const std::string &name)
+{
+  setOption(name);
+
+  for (auto &override : overrides_)
+    if (override.name == name)
+      override.remove = true;
+}
+
+void
+CArgvBuilder::
+setPositionals(const StringList &positionals)
+{
+  positionals_    = positionals;
+  positionalsSet_ = true;
+}
+
+void
+CArgvBuilder::
+addPositional(const std::string &positional)
+{
+  if (! positionalsSet_)
+    setPositionals(cargs_.getPositionals());
+
+  positionals_.push_back(positional);
+}
+
+const CArgvBuilder::Override *
+CArgvBuilder::
+lookupOverride(const std::string_view &name) const
+{
+  for (const auto &override : overrides_)
+    if (override.name == name)
+      return &override;
+
+  return nullptr;
+}
+
+bool
+CArgvBuilder::
+optionValues(const CArg *arg, bool defaults, StringList &values)
+{
+  values.clear();
+
+  const Override *override = lookupOverride(arg->getNameView());
+
+  if      (override) {
+    if (override->remove)
+      return false;
+
+    values = override->values;
+  }
+  else if (arg->getSet())
+    arg->getValueStrings(values);
+  else if (defaults) {
+    arg->getValueStrings(values);
+
+    // no default (e.g. empty list)
+    if (values.empty())
+      return false;
+  }
+  else
+    return false;
+
+  // flag has no value (or a boolean value)
+  if (arg->getType() == CARG_TYPE_BOOLEAN)
+    return (values.empty() || (values[0] != "0" && values[0] != "false"));
+
+  // no value string (e.g. custom type without format proc) so option can
+  // not be passed on
+  if (values.empty()) {
+    skipped_.push_back(std::string(arg->getNameView()));
+    return false;
+  }
+
+  return true;
+}
+
+void
+CArgvBuilder::
+addToken(const std::string_view &str1, const std::string_view &str2)
+{
+  offsets_.push_back(buffer_.size());
+
+  buffer_ += str1;
+  buffer_ += str2;
+  buffer_ += '\0';
+}
+
+char **
+CArgvBuilder::
+build()
+{
+  buffer_ .clear();
+  offsets_.clear();
+  argv_   .clear();
+  skipped_.clear();
+
+  if (! keepSpillFile_)
+    removeSpillFile();
+
+  addToken(prog_);
+
+  //---
+
+  // options in definition order (then overrides for options not in definition)
+  int num_args = cargs_.getNumArgs();
+
+  for (int i = 0; i < num_args; ++i) {
+    const CArg *arg = cargs_.getArg(i);
+
+    if (! optionValues(arg, false, values_))
+      continue;
+
+    std::string_view name = arg->getNameView();
+
+    if (arg->getType() == CARG_TYPE_BOOLEAN) {
+      addToken(name);
+
+      continue;
+    }
+
+    for (const auto &value : values_) {
+      if (arg->getAttached())
+        addToken(name, value);
+      else {
+        addToken(name);
+        addToken(value);
+      }
+    }
+  }
+
+  for (const auto &override : overrides_) {
+    if (override.remove || cargs_.getArgIndex(override.name) >= 0)
+      continue;
+
+    addToken(override.name);
+
+    for (const auto &value : override.values)
+      addToken(value);
+  }
+
+  //---
+
+  const StringList &positionals = (positionalsSet_ ? positionals_ : cargs_.getPositionals());
+
+  // index of '--' token (0 if none)
+  size_t dash = 0;
+
+  for (const auto &positional : positionals) {
+    if (! dash && needsDash(positional)) {
+      dash = offsets_.size();
+
+      addToken("--");
+    }
+
+    addToken(positional);
+  }
+
+  //---
+
+  // total size as counted by kernel (strings and pointers)
+  auto num_tokens = offsets_.size();
+
+  if (buffer_.size() + (num_tokens + 1)*sizeof(char *) > argMax_) {
+    // keep leading tokens which fit with '@<file>' token
+    size_t reserve = 64 + sizeof(char *);
+
+    size_t keep = 1, size = offsets_[1] + 2*sizeof(char *);
+
+    while (keep < num_tokens) {
+      size_t len = (keep + 1 < num_tokens ? offsets_[keep + 1] : buffer_.size()) - offsets_[keep];
+
+      if (size + len + sizeof(char *) + reserve > argMax_)
+        break;
+
+      size += len + sizeof(char *);
+
+      ++keep;
+    }
+
+    // response files are not expanded after '--' so it must be in the file
+    if (dash && keep > dash)
+      keep = dash;
+
+    spill(keep);
+  }
+
+  //---
+
+  for (auto offset : offsets_)
+    argv_.push_back(&buffer_[offset]);
+
+  argv_.push_back(nullptr);
+
+  return &argv_[0];
+}
+
+const std::string &
+CArgvBuilder::
+canonical(bool defaults)
+{
+  canonical_.clear();
+  skipped_  .clear();
+
+  quote(prog_, canonical_);
+
+  int num_args = cargs_.getNumArgs();
+
+  for (int i = 0; i < num_args; ++i) {
+    const CArg *arg = cargs_.getArg(i);
+
+    if (! optionValues(arg, defaults, values_))
+      continue;
+
+    std::string_view name = arg->getNameView();
+
+    if (arg->getType() == CARG_TYPE_BOOLEAN) {
+      canonical_ += ' ';
+      canonical_ += name;
+
+      continue;
+    }
+
+    // option names need no quoting so attached value is quoted separately
+    for (const auto &value : values_) {
+      canonical_ += ' ';
+      canonical_ += name;
+
+      if (! arg->getAttached())
+        canonical_ += ' ';
+
+      quote(value, canonical_);
+    }
+  }
+
+  for (const auto &override : overrides_) {
+    if (override.remove || cargs_.getArgIndex(override.name) >= 0)
+      continue;
+
+    canonical_ += ' ';
+
+    quote(override.name, canonical_);
+
+    for (const auto &value : override.values) {
+      canonical_ += ' ';
+
+      quote(value, canonical_);
+    }
+  }
+
+  const StringList &positionals = (positionalsSet_ ? positionals_ : cargs_.getPositionals());
+
+  bool dash = false;
+
+  for (const auto &positional : positionals) {
+    canonical_ += ' ';
+
+    if (! dash && needsDash(positional)) {
+      canonical_ += "-- ";
+
+      dash = true;
+    }
+
+    quote(positional, canonical_);
+  }
+
+  return canonical_;
+}
+
+// write tokens from 'keep' onwards to response file and replace with '@<file>'
+void
+CArgvBuilder::
+spill(size_t keep)
+{
+  const char *tmpdir = getenv("TMPDIR");
+
+  std::string filename = std::string(tmpdir && *tmpdir ? tmpdir : "/tmp") + "/cargsXXXXXX";
+
+  int fd = mkstemp(&filename[0]);
+
+  if (fd < 0) {
+    CTHROW("Failed to create response file " + filename);
+    return;
+  }
+
+  std::string text;
+
+  auto num_tokens = offsets_.size();
+
+  for (size_t i = keep; i < num_tokens; ++i) {
+    quote(std::string(&buffer_[offsets_[i]]), text);
+
+    text += '\n';
+  }
+
+  const char *p   = text.c_str();
+  size_t      len = text.size();
+
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+
+    if (n <= 0) {
+      close(fd);
+      unlink(filename.c_str());
+      CTHROW("Failed to write response file " + filename);
+      return;
+    }
+
+    p   += n;
+    len -= size_t(n);
+  }
+
+  close(fd);
+
+  spillFile_ = filename;
+
+  buffer_.resize(offsets_[keep]);
+  offsets_.resize(keep);
+
+  addToken("@", spillFile_);
+}
+
+// positional which would be read as an option or response file
+bool
+CArgvBuilder::
+needsDash(const std::string &positional)
+{
+  return (positional != "" && (positional[0] == '-' || positional[0] == '@'));
+}
+
+void
+CArgvBuilder::
+removeSpillFile()
+{
+  if (spillFile_ != "") {
+    unlink(spillFile_.c_str());
+
+    spillFile_ = "";
+  }
+}
+
+void
+CArgvBuilder::
+quote(const std::string &str, std::string &out)
+{
+  static const char *safe = "_@%+=:,./-";
+
+  bool needQuote = str.empty();
+
+  for (auto c : str) {
+    if (! isalnum(static_cast<unsigned char>(c)) && ! strchr(safe, c)) {
+      needQuote = true;
+      break;
+    }
+  }
+
+  if (! needQuote) {
+    out += str;
+    return;
+  }
+
+  out += '\'';
+
+  for (auto c : str) {
+    if (c == '\'')
+      out += "'\\''";
+    else
+      out += c;
+  }
+
+  out += '\'';
+}
@@ -1,28 +1,71 @@
 #include <CArgs.h>
+#include <CArgsView.h>
 
 static std::string opts = "\
 -1:f (one) \
 -2:f (two) \
 -3:f (three) \
 -f:fr=1 \
--i:ir=1 \
+-i:i{1,256}r=1 \
 -I:Ir=3 \
 -r:rr=4.5 \
 -R:Rr=8.3 \
--s:sr=Fred \
+-s:s/[A-Z][a-z]*/r=Fred \
 -S:Sr=Bill \
 -c:c[a,b,c]r \
--C:C[d,e,f]r";
+-C:C[d,e,f]r \
+-z:c[utc=0,gmt=0,est=-5]n \
+-cache:b=4GiB \
+-timeout:t=250ms \
+-rate:q=10k/s \
+-pos:x=1,2 \
+-in:p[exists,file,readable]m";
+
+CARG_ENUM(Codec, h264, vp9, av1)
+
+struct Point {
+  double x { 0.0 };
+  double y { 0.0 };
+};
+
+static bool
+parsePoint(const char *str, Point &p)
+{
+  char *end;
+
+  p.x = strtod(str, &end);
+
+  if (end == str || *end != ',')
+    return false;
+
+  str = end + 1;
+
+  p.y = strtod(str, &end);
+
+  return (end != str && *end == '\0');
+}
 
 int
 main(int argc, char **argv)
 {
-  CArgs cargs(opts);
+  CArgs cargs;
+
+  cargs.registerType('x', "point", parsePoint);
+
+  cargs.setFormat(opts);
+
+  cargs.setGlobPositionals(true);
+  cargs.setResponseFiles  (true);
+
+  cargs.addEnumArg("-codec", CARG_FLAG_NO_CASE, Codec::h264, false, "codec");
 
   // cargs->print();
 
   cargs.usage(argv[0]);
 
+  cargs.setIntegerAction("-i", [](long i) {
+    std::cout << "action -i " << i << std::endl; });
+
   cargs.parse(&argc, argv);
 
   std::cout << "-1 " << cargs.getBooleanArg("-1") << std::endl;
@@ -37,9 +80,33 @@ main(int argc, char **argv)
   std::cout << "-S " << cargs.getStringArg ("-S") << std::endl;
   std::cout << "-c " << cargs.getChoiceArg ("-c") << std::endl;
   std::cout << "-C " << cargs.getChoiceArg ("-C") << std::endl;
+  std::cout << "-z " << cargs.getChoiceArg ("-z") << std::endl;
+
+  std::cout << "-cache "   << cargs.getSizeArg    ("-cache"  ) << std::endl;
+  std::cout << "-timeout " << cargs.getDurationArg("-timeout") << std::endl;
+  std::cout << "-rate "    << cargs.getRateArg    ("-rate"   ) << std::endl;
+
+  Point pos = cargs.getCustomArg<Point>("-pos");
+
+  std::cout << "-pos " << pos.x << "," << pos.y << std::endl;
+
+  for (const auto &path : cargs.getPathListArg("-in"))
+    std::cout << "-in " << path << std::endl;
+
+  std::cout << "-codec " << int(cargs.getArg<Codec>("-codec")) << std::endl;
 
   for (int i = 1; i < argc; i++)
     std::cout << argv[i] << std::endl;
 
+  for (const auto &positional : cargs.getPositionals())
+    std::cout << "positional " << positional << std::endl;
+
+  CArgsView view(cargs);
+
+  std::cout << "view -i " << view.getIntegerArg("-i") << std::endl;
+  std::cout << "view -s " << view.getStringArg ("-s") << std::endl;
+
+  std::cout << "fingerprint " << cargs.getFingerprint().toString() << std::endl;
+
   return 0;
 }
@@ -0,0 +1,1880 @@
+#include <CArgs.h>
+#include <CArgsCache.h>
+#include <CArgsFixed.h>
+#include <CArgsGlob.h>
+#include <CArgsLayers.h>
+#include <CArgvBuilder.h>
+#include <CArgsRegistry.h>
+#include <CArgsStruct.h>
+#include <CArgsTokenizer.h>
+#include <CArgsView.h>
+#include <CArgsWatcher.h>
+#include <CArgsUnitTestGen.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// checks of modules built on CArgs (exit status is number of failures)
+
+static int num_failed = 0;
+
+#define CHECK(COND) \
+  do { \
+    if (! (COND)) { \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #COND "\n"; \
+      ++num_failed; \
+    } \
+  } while (0)
+
+static std::vector<std::string>
+toStrings(char **argv)
+{
+  std::vector<std::string> args;
+
+  for ( ; *argv; ++argv)
+    args.push_back(*argv);
+
+  return args;
+}
+
+// parse as child process would (argv)
+static bool
+parseArgv(CArgs &cargs, const std::vector<std::string> &args)
+{
+  std::vector<char *> argv;
+
+  for (const auto &arg : args)
+    argv.push_back(const_cast<char *>(arg.c_str()));
+
+  argv.push_back(nullptr);
+
+  return cargs.parse(int(args.size()), &argv[0]);
+}
+
+// temporary directory (removed at exit)
+static std::string
+tempDir()
+{
+  static std::string dir;
+
+  if (dir == "") {
+    char path[] = "/tmp/cargsXXXXXX";
+
+    dir = mkdtemp(path);
+
+    atexit([]() { std::string cmd = "rm -rf " + dir; (void) system(cmd.c_str()); });
+  }
+
+  return dir;
+}
+
+static void
+writeFile(const std::string &filename, const std::string &text)
+{
+  std::ofstream os(filename);
+
+  os << text;
+}
+
+// wait (up to 5s) for condition
+template<typename T>
+static bool
+waitFor(const T &cond)
+{
+  for (int i = 0; i < 500; ++i) {
+    if (cond())
+      return true;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  return cond();
+}
+
+// check that procedure throws
+template<typename T>
+static bool
+throws(const T &proc)
+{
+  try {
+    proc();
+  }
+  catch (...) {
+    return true;
+  }
+
+  return false;
+}
+
+static bool
+parsePort(const char *str, int &port)
+{
+  char *end;
+
+  port = int(strtol(str, &end, 10));
+
+  return (end != str && *end == '\0');
+}
+
+//------
+
+static void
+testChoice()
+{
+  // label=value choices (values can be shared), hashed lookup
+  {
+    CArgs cargs("-tz:c[utc=0,gmt=0,est=-5,pst=-8] (zone) -c:c[a,b,c] (index)");
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-tz", "est", "-c", "c" }));
+    CHECK(cargs.getChoiceArg("-tz") == -5);
+    CHECK(cargs.getChoiceArg("-c") == 2);
+
+    long value;
+
+    auto *arg = dynamic_cast<CArgChoice *>(cargs.getArg(0));
+
+    CHECK(arg && arg->getChoices().size() == 4);
+    CHECK(arg && arg->lookupChoice("gmt", value) && value == 0);
+    CHECK(arg && arg->lookupChoice("pst", value) && value == -8);
+    CHECK(arg && ! arg->lookupChoice("PST", value));
+    CHECK(arg && ! arg->lookupChoice("", value));
+  }
+
+  // no case (choice names folded)
+  {
+    CArgs cargs("-tz:c[UTC=0,Est=-5]n (zone)");
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-TZ", "eST" }));
+    CHECK(cargs.getChoiceArg("-tz") == -5);
+
+    CArgs cargs1("-tz:c[UTC=0,Est=-5]n (zone)");
+
+    CHECK(cargs1.parse(std::vector<std::string>{ "prog", "-tz", "utc" }));
+    CHECK(cargs1.getChoiceArg("-tz") == 0);
+  }
+
+  // duplicate labels (also after case folding)
+  CHECK(throws([]() { CArgs cargs("-c:c[a,b,a] (choice)"); }));
+  CHECK(throws([]() { CArgs cargs("-c:c[a=1,A=2]n (choice)"); }));
+  CHECK(! throws([]() { CArgs cargs("-c:c[a=1,A=2] (choice)"); }));
+
+  // unknown choice
+  {
+    CArgs cargs("-c:c[a,b=5]=5 (choice)");
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-c", "x" }));
+    CHECK(cargs.getErrors().size() == 1);
+    CHECK(cargs.getChoiceArg("-c") == 5);
+  }
+}
+
+//------
+
+CARG_ENUM(Codec, h264, vp9, av1, hevc, mpeg2, theora, prores, dnxhd, ffv1)
+
+namespace CArgsUnitTest {
+  enum class Level { low, medium, high };
+
+  constexpr const char *cargEnumNames(Level) { return "low, medium, high"; }
+}
+
+// every enumerator name is in the slot its displacement hashes it to
+template<typename E>
+constexpr bool
+enumTableValid()
+{
+  typedef CArgEnumTable<E> Table;
+
+  for (std::size_t i = 0; i < Table::numNames; ++i) {
+    const char  *name = &Table::str[Table::entries[i].pos];
+    std::size_t  len  = Table::entries[i].len;
+
+    uint32_t d = Table::table.disp[CArgEnumUtil::hash(name, len, 0) & (Table::numSlots - 1)];
+
+    if (d == 0 || Table::table.slots[CArgEnumUtil::hash(name, len, d) &
+                                     (Table::numSlots - 1)] != int(i))
+      return false;
+  }
+
+  return true;
+}
+
+static_assert(CArgEnumTable<Codec>::numNames == 9, "Codec names");
+static_assert(enumTableValid<Codec>(), "Codec perfect hash");
+static_assert(enumTableValid<CArgsUnitTest::Level>(), "Level perfect hash");
+
+static void
+testEnum()
+{
+  typedef CArgEnumTable<Codec> Table;
+
+  CHECK(Table::numValues() == 9);
+
+  // every enumerator maps to its value (also case folded)
+  for (std::size_t i = 0; i < Table::numValues(); ++i) {
+    std::string name = Table::name(i);
+
+    Codec value;
+
+    CHECK(Table::lookup(name.c_str(), false, value) && value == Codec(i));
+
+    std::string upper = name;
+
+    for (auto &c : upper)
+      c = char(toupper(static_cast<unsigned char>(c)));
+
+    CHECK(Table::lookup(upper.c_str(), true, value) && value == Codec(i));
+    CHECK(upper == name || ! Table::lookup(upper.c_str(), false, value));
+  }
+
+  // unknown names (prefix, extension, empty)
+  for (const char *name : { "", "h26", "h2644", "vp", "av1 ", "x", "theoraa", "ffv" }) {
+    Codec value;
+
+    CHECK(! Table::lookup(name, true, value));
+  }
+
+  // enum option
+  {
+    CArgs cargs;
+
+    cargs.addEnumArg("-codec", CARG_FLAG_NO_CASE, Codec::vp9, false, "codec");
+    cargs.addEnumArg("-level", CARG_FLAG_NONE, CArgsUnitTest::Level::medium, false, "level");
+
+    CHECK(cargs.getArg<Codec>("-codec") == Codec::vp9);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-codec", "HEVC", "-level", "high" }));
+    CHECK(cargs.getArg<Codec>("-codec") == Codec::hevc);
+    CHECK(cargs.getArg<CArgsUnitTest::Level>("-level") == CArgsUnitTest::Level::high);
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-level", "HIGH" }));
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-codec", "h265" }));
+    CHECK(cargs.getArg<Codec>("-codec") == Codec::hevc);
+  }
+}
+
+//------
+
+static void
+testValidate()
+{
+  // inverted range
+  CHECK(throws([]() { CArgs cargs("-n:i{10,1} (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-r:r{1.5,0.5} (real)"); }));
+
+  // default out of range
+  CHECK(throws([]() { CArgs cargs("-n:i{1,10}=20 (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-n:i{1,}=0 (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-r:r{0,1}=2 (real)"); }));
+
+  // invalid range and pattern
+  CHECK(throws([]() { CArgs cargs("-n:i{1,x} (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-n:i{1,10 (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-s:s{1,10} (string)"); }));
+  CHECK(throws([]() { CArgs cargs("-n:i/[0-9]+/ (number)"); }));
+  CHECK(throws([]() { CArgs cargs("-s:s/[a-z/ (string)"); }));
+
+  // open range, default in range
+  CHECK(! throws([]() { CArgs cargs("-n:i{1,}=1 -m:i{,0}=-5 -r:r{0,1}=1 (number)"); }));
+
+  // range set by API
+  {
+    CArgs cargs("-n:i=5 (number) -r:r (real)");
+
+    CHECK(throws([&]() { cargs.setIntegerRange("-n", 10, 1); }));
+    CHECK(throws([&]() { cargs.setRealRange("-r", 1.0, 0.0); }));
+
+    cargs.setIntegerRange("-n", 1, 10);
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-n", "11" }));
+    CHECK(cargs.getIntegerArg("-n") == 5);
+  }
+
+  // values in range and matching pattern
+  {
+    CArgs cargs("-n:i{1,10} (number) -r:r{0,1} (real) -s:s/[a-z]+\\/[0-9]+/ (string)");
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "10", "-r", "0", "-s", "ab/12" }));
+    CHECK(cargs.getIntegerArg("-n") == 10);
+    CHECK(cargs.getStringArg("-s") == "ab/12");
+  }
+
+  // all failures are reported together (in argument order)
+  {
+    std::string opts = "-n:i{1,10} (number) -r:r{0,1} (real) -s:s/[a-z]+/ (string) "
+                       "-D:S/[A-Z]+=[0-9]+/m (define)";
+
+    CArgs cargs(opts);
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-s", "ABC", "-n", "0", "-DX=1",
+                                                  "-r", "1.5", "-DY=y" }));
+
+    const auto &errors = cargs.getErrors();
+
+    CHECK(errors.size() == 4);
+
+    if (errors.size() == 4) {
+      CHECK(errors[0].find("-s") != std::string::npos &&
+            errors[0].find("does not match /[a-z]+/") != std::string::npos);
+      CHECK(errors[1].find("out of range [1,10]") != std::string::npos);
+      CHECK(errors[2].find("-r") != std::string::npos);
+      CHECK(errors[3].find("Invalid Value Y=y for -D ") == 0);
+    }
+
+    CHECK(cargs.getStringListArg("-D") == (std::vector<std::string>{ "X=1" }));
+
+    // same errors from argv
+    CArgs cargs1(opts);
+
+    CHECK(! parseArgv(cargs1, { "prog", "-s", "ABC", "-n", "0", "-DX=1", "-r", "1.5", "-DY=y" }));
+    CHECK(cargs1.getErrors() == errors);
+  }
+}
+
+//------
+
+static void
+testUnits()
+{
+  long value, count, period;
+
+  // sizes
+  CHECK(CArgSize::parseValue("512", value) && value == 512);
+  CHECK(CArgSize::parseValue("1k", value) && value == 1000);
+  CHECK(CArgSize::parseValue("1K", value) && value == 1000);
+  CHECK(CArgSize::parseValue("1kB", value) && value == 1000);
+  CHECK(CArgSize::parseValue("1Ki", value) && value == 1024);
+  CHECK(CArgSize::parseValue("2KiB", value) && value == 2048);
+  CHECK(CArgSize::parseValue("1.5M", value) && value == 1500000);
+  CHECK(CArgSize::parseValue("4GiB", value) && value == 4L*1024*1024*1024);
+  CHECK(CArgSize::parseValue("7EiB", value) && value == 7L*1024*1024*1024*1024*1024*1024);
+
+  CHECK(! CArgSize::parseValue("8EiB", value));
+  CHECK(! CArgSize::parseValue("99999999999999999999", value));
+  CHECK(! CArgSize::parseValue("1x", value));
+  CHECK(! CArgSize::parseValue("1 k", value));
+  CHECK(! CArgSize::parseValue("k", value));
+  CHECK(! CArgSize::parseValue("", value));
+  CHECK(! CArgSize::parseValue("-1k", value));
+
+  // durations (nanoseconds, default seconds)
+  CHECK(CArgDuration::parseValue("250ms", value) && value == 250000000L);
+  CHECK(CArgDuration::parseValue("2s", value) && value == 2000000000L);
+  CHECK(CArgDuration::parseValue("30", value) && value == 30000000000L);
+  CHECK(CArgDuration::parseValue("1.5h", value) && value == 5400000000000L);
+  CHECK(CArgDuration::parseValue("2m", value) && value == 120000000000L);
+  CHECK(CArgDuration::parseValue("2min", value) && value == 120000000000L);
+  CHECK(CArgDuration::parseValue("10us", value) && value == 10000L);
+
+  CHECK(! CArgDuration::parseValue("1000000d", value));
+  CHECK(! CArgDuration::parseValue("5y", value));
+  CHECK(! CArgDuration::parseValue("ms", value));
+
+  // rates (count per period)
+  CHECK(CArgRate::parseValue("10k/s", count, period) &&
+        count == 10000 && period == 1000000000L);
+  CHECK(CArgRate::parseValue("20", count, period) &&
+        count == 20 && period == 1000000000L);
+  CHECK(CArgRate::parseValue("500/ms", count, period) &&
+        count == 500 && period == 1000000L);
+
+  // fractional count is exact
+  CHECK(CArgRate::parseValue("0.5/s", count, period) &&
+        count*2000000000L == period);
+  CHECK(CArgRate::parseValue("0.5k/s", count, period) &&
+        count*1000000000L == 500*period);
+  CHECK(CArgRate::parseValue("2.5/min", count, period) &&
+        count*60000000000L == 5*period/2);
+
+  CHECK(! CArgRate::parseValue("99999999999T/s", count, period));
+  CHECK(! CArgRate::parseValue("10/x", count, period));
+  CHECK(! CArgRate::parseValue("10/", count, period));
+  CHECK(! CArgRate::parseValue("10x", count, period));
+
+  // options
+  {
+    CArgs cargs("-z:b=1Ki (size) -t:t=250ms (timeout) -q:q=0.5k/s (rate)");
+
+    CHECK(cargs.getSizeArg("-z") == 1024);
+    CHECK(cargs.getDurationArg("-t") == 250000000L);
+    CHECK(cargs.getRateArg("-q") == 500.0);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-z", "2M", "-t", "2s", "-q", "10k/s" }));
+    CHECK(cargs.getSizeArg("-z") == 2000000);
+    CHECK(cargs.getDurationArg("-t") == 2000000000L);
+    CHECK(cargs.getRateArg("-q") == 10000.0);
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-z", "2X", "-t", "1000000d",
+                                                  "-q", "1/x" }));
+    CHECK(cargs.getErrors().size() == 3);
+    CHECK(cargs.getSizeArg("-z") == 2000000);
+  }
+
+  CHECK(throws([]() { CArgs cargs("-z:b=1X (size)"); }));
+}
+
+//------
+
+struct Point {
+  int x { 0 };
+  int y { 0 };
+};
+
+static bool
+parsePoint(const char *str, Point &point)
+{
+  int n = 0;
+
+  return (sscanf(str, "%d,%d%n", &point.x, &point.y, &n) == 2 && str[n] == '\0');
+}
+
+static std::string
+formatPoint(const Point &point)
+{
+  return std::to_string(point.x) + "," + std::to_string(point.y);
+}
+
+static void
+testCustom()
+{
+  CArgs cargs;
+
+  cargs.registerType('x', "point", parsePoint, formatPoint);
+  cargs.registerType('y', "port", parsePort);
+
+  cargs.setFormat("-at:x=1,2 (point) -P:X (attached point) -port:y (port)");
+
+  CHECK(cargs.isCustomArg("-at"));
+  CHECK(cargs.getCustomArg<Point>("-at").x == 1 && cargs.getCustomArg<Point>("-at").y == 2);
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-at", "-3,4", "-P5,6", "-port", "80" }));
+  CHECK(cargs.getCustomArg<Point>("-at").x == -3 && cargs.getCustomArg<Point>("-at").y == 4);
+  CHECK(cargs.getCustomArg<Point>(1).x == 5);
+  CHECK(cargs.getCustomArg<int>("-port") == 80);
+
+  // formatted value parses back to same value
+  {
+    std::vector<std::string> values;
+
+    cargs.getArg(0)->getValueStrings(values);
+
+    CHECK(values == (std::vector<std::string>{ "-3,4" }));
+
+    Point point;
+
+    CHECK(parsePoint(values[0].c_str(), point) && point.x == -3 && point.y == 4);
+  }
+
+  // invalid value leaves value unchanged
+  CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-at", "7" }));
+  CHECK(cargs.getCustomArg<Point>("-at").x == -3);
+
+  // type mismatch
+  CHECK(throws([&]() { (void) cargs.getCustomArg<int>("-at"); }));
+  CHECK(throws([&]() { (void) cargs.getCustomArg<Point>("-port"); }));
+  CHECK(throws([&]() { (void) cargs.getCustomArg<Point>(2); }));
+
+  // builtin, duplicate and unknown type letters
+  {
+    CArgs cargs1;
+
+    CHECK(throws([&]() { cargs1.registerType('s', "str", parsePort); }));
+    CHECK(throws([&]() { cargs1.registerType('X', "upper", parsePort); }));
+
+    cargs1.registerType('x', "port", parsePort);
+
+    CHECK(throws([&]() { cargs1.registerType('x', "port2", parsePort); }));
+    CHECK(throws([&]() { cargs1.setFormat("-a:z (unknown)"); }));
+    CHECK(throws([&]() { cargs1.addCustomArg("-b", "point", 0, "", false, "point"); }));
+  }
+}
+
+//------
+
+static void
+testPaths()
+{
+  std::string dir = tempDir() + "/paths";
+
+  CHECK(mkdir(dir.c_str(), 0755) == 0);
+
+  writeFile(dir + "/file", "text");
+
+  std::string file    = dir + "/file";
+  std::string missing = dir + "/missing";
+
+  // checks pass
+  {
+    CArgs cargs("-in:p[exists,file,readable] (input) -out:p[dir,writable] (output) "
+                "-any:p (any)");
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-in", file, "-out", dir,
+                                                "-any", missing }));
+    CHECK(cargs.getPathArg("-in") == file);
+    CHECK(cargs.getPathArg("-any") == missing);
+  }
+
+  // each failing check is reported (in argument order)
+  {
+    CArgs cargs("-in:p[exists] (input) -f:p[file]m (files) -d:p[dir] (directory)");
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-f", dir, "-in", missing,
+                                                  "-f", file, "-d", file }));
+
+    CHECK(cargs.getErrors() == (std::vector<std::string>{
+      "Path " + missing + " for -in does not exist",
+      "Path " + dir     + " for -f is not a file",
+      "Path " + file    + " for -d is not a directory" }));
+
+    CHECK(cargs.getPathListArg("-f") == (std::vector<std::string>{ dir, file }));
+  }
+
+  // large batch (checked by threads) reports same errors in same order
+  {
+    CArgs cargs("-f:p[file]m (files)");
+
+    std::vector<std::string> args { "prog" };
+    std::vector<std::string> errors;
+
+    for (int i = 0; i < 100; ++i) {
+      std::string path = (i % 7 == 0 ? dir + "/missing" + std::to_string(i) : file);
+
+      args.push_back("-f");
+      args.push_back(path);
+
+      if (i % 7 == 0)
+        errors.push_back("Path " + path + " for -f does not exist");
+    }
+
+    CHECK(! cargs.parse(args));
+    CHECK(cargs.getErrors() == errors);
+  }
+
+  CHECK(throws([]() { CArgs cargs("-in:p[exists,big] (input)"); }));
+}
+
+//------
+
+static void
+testGlob()
+{
+  std::string dir = tempDir() + "/glob";
+
+  CHECK(mkdir(dir.c_str(), 0755) == 0);
+  CHECK(mkdir((dir + "/sub1").c_str(), 0755) == 0);
+  CHECK(mkdir((dir + "/sub2").c_str(), 0755) == 0);
+  CHECK(mkdir((dir + "/a*b").c_str(), 0755) == 0);
+
+  for (const char *name : { "c.txt", "a.txt", "b.txt", "a.dat", "sub1/x.txt",
+                            "sub2/y.txt", "a*b/z.txt", ".hidden.txt" })
+    writeFile(dir + "/" + name, "");
+
+  auto expand = [](const CArgsGlob::StringList &patterns) {
+    CArgsGlob::StringList results;
+
+    CArgsGlob::expand(patterns, results, 4);
+
+    return results;
+  };
+
+  // sorted matches (pattern order kept), hidden files not matched
+  CHECK(expand({ dir + "/*.txt", dir + "/?.dat" }) ==
+        (CArgsGlob::StringList{ dir + "/a.txt", dir + "/b.txt", dir + "/c.txt",
+                                dir + "/a.dat" }));
+
+  CHECK(expand({ dir + "/sub[0-9]/*.txt" }) ==
+        (CArgsGlob::StringList{ dir + "/sub1/x.txt", dir + "/sub2/y.txt" }));
+
+  // unmatched pattern (and non pattern) kept as is
+  CHECK(expand({ dir + "/*.none", "plain", dir + "/a.txt" }) ==
+        (CArgsGlob::StringList{ dir + "/*.none", "plain", dir + "/a.txt" }));
+
+  // escaped wildcard is literal
+  CHECK(! CArgsGlob::isPattern("a\\*b"));
+  CHECK(CArgsGlob::isPattern("a\\**"));
+
+  CHECK(expand({ dir + "/a\\*b/*.txt" }) == (CArgsGlob::StringList{ dir + "/a*b/z.txt" }));
+  CHECK(expand({ dir + "/a\\**" }) == (CArgsGlob::StringList{ dir + "/a*b" }));
+
+  // trailing '/' only matches directories
+  CHECK(expand({ dir + "/*/" }) ==
+        (CArgsGlob::StringList{ dir + "/a*b/", dir + "/sub1/", dir + "/sub2/" }));
+
+  // positionals
+  {
+    CArgs cargs("-v:f (verbose)");
+
+    cargs.setGlobPositionals(true);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", dir + "/[ab].txt", "-v", "x*y" }));
+    CHECK(cargs.getPositionals() ==
+          (std::vector<std::string>{ dir + "/a.txt", dir + "/b.txt", "x*y" }));
+  }
+}
+
+//------
+
+static void
+testArgvBuilder()
+{
+  static const char *opts = "-v:f (verbose) -n:i=1 (number) -o:s (output) -D:Sm (define)";
+
+  CArgs cargs(opts);
+
+  CHECK(parseArgv(cargs, { "prog", "-v", "-n", "3", "-o", "a b",
+                          "-DX=1", "-DY", "--", "-p", "@q", "r" }));
+
+  // round trip
+  {
+    CArgvBuilder builder(cargs, "child");
+
+    auto args = toStrings(builder.build());
+
+    CHECK(args == (std::vector<std::string>{ "child", "-v", "-n", "3", "-o", "a b",
+                                             "-DX=1", "-DY", "--", "-p", "@q", "r" }));
+
+    CArgs cargs1(opts);
+
+    cargs1.setResponseFiles(true);
+
+    CHECK(parseArgv(cargs1, args));
+    CHECK(cargs1.getIntegerArg("-n") == 3);
+    CHECK(cargs1.getStringArg("-o") == "a b");
+    CHECK(cargs1.getStringListArg("-D") == (std::vector<std::string>{ "X=1", "Y" }));
+    CHECK(cargs1.getPositionals() == (std::vector<std::string>{ "-p", "@q", "r" }));
+
+    CHECK(builder.canonical() == "child -v -n 3 -o 'a b' -DX=1 -DY -- -p @q r");
+  }
+
+  // quoting (bytes of UTF-8 characters are not safe characters)
+  {
+    std::string out;
+
+    CArgvBuilder::quote("a-b.c", out);
+    CArgvBuilder::quote("it's", out);
+    CArgvBuilder::quote("caf\xc3\xa9", out);
+    CArgvBuilder::quote("\xff", out);
+
+    CHECK(out == "a-b.c'it'\\''s''caf\xc3\xa9''\xff'");
+  }
+
+  // '--' before response file like positional
+  {
+    CArgvBuilder builder(cargs, "child");
+
+    builder.setPositionals({ "a", "@b" });
+
+    CHECK(toStrings(builder.build()) ==
+          (std::vector<std::string>{ "child", "-v", "-n", "3", "-o", "a b",
+                                     "-DX=1", "-DY", "a", "--", "@b" }));
+  }
+
+  // spill (limit only fits program and a few options)
+  for (size_t argMax : { 100, 110, 120, 130, 140 }) {
+    auto builder = std::make_unique<CArgvBuilder>(cargs, "child");
+
+    builder->setArgMax(argMax);
+
+    auto args = toStrings(builder->build());
+
+    std::string spillFile = builder->spillFile();
+
+    CHECK(spillFile != "");
+    CHECK(args.back() == "@" + spillFile);
+
+    // '--' is never left before the response file
+    CHECK(std::find(args.begin(), args.end(), "--") == args.end());
+
+    CArgs cargs1(opts);
+
+    cargs1.setResponseFiles(true);
+
+    CHECK(parseArgv(cargs1, args));
+    CHECK(cargs1.getBooleanArg("-v"));
+    CHECK(cargs1.getIntegerArg("-n") == 3);
+    CHECK(cargs1.getStringArg("-o") == "a b");
+    CHECK(cargs1.getStringListArg("-D") == (std::vector<std::string>{ "X=1", "Y" }));
+    CHECK(cargs1.getPositionals() == (std::vector<std::string>{ "-p", "@q", "r" }));
+
+    // removed with builder
+    builder.reset();
+
+    CHECK(access(spillFile.c_str(), F_OK) != 0);
+  }
+
+  // spill of long positional after '--' moves '--' to response file
+  {
+    std::string longArg(300, 'x');
+
+    CArgvBuilder builder(cargs, "child");
+
+    builder.setPositionals({ "-p", longArg });
+    builder.setArgMax(300);
+
+    auto args = toStrings(builder.build());
+
+    CHECK(std::find(args.begin(), args.end(), "--") == args.end());
+
+    CArgs cargs1(opts);
+
+    cargs1.setResponseFiles(true);
+
+    CHECK(parseArgv(cargs1, args));
+    CHECK(cargs1.getPositionals() == (std::vector<std::string>{ "-p", longArg }));
+  }
+
+  // custom type without format proc is left out (not an error)
+  {
+    CArgs cargs1;
+
+    cargs1.registerType('x', "port", parsePort);
+
+    cargs1.setFormat("-n:i (number) -port:x (port)");
+
+    CHECK(parseArgv(cargs1, { "prog", "-n", "1", "-port", "80" }));
+
+    CArgvBuilder builder(cargs1, "child");
+
+    CHECK(toStrings(builder.build()) == (std::vector<std::string>{ "child", "-n", "1" }));
+    CHECK(builder.skippedOptions() == (std::vector<std::string>{ "-port" }));
+
+    CHECK(builder.canonical() == "child -n 1");
+    CHECK(builder.skippedOptions() == (std::vector<std::string>{ "-port" }));
+  }
+}
+
+//------
+
+static void
+testWatcher()
+{
+  std::string filename = tempDir() + "/watch.cfg";
+
+  writeFile(filename, "-n 5\n");
+
+  CArgsWatcher watcher("-n:i=1 (number)", filename);
+
+  CHECK(watcher.start());
+  CHECK(watcher.snapshot()->getIntegerArg("-n") == 5);
+
+  auto generation = watcher.generation();
+
+  // replace by rename
+  writeFile(filename + ".tmp", "-n 6\n");
+
+  CHECK(rename((filename + ".tmp").c_str(), filename.c_str()) == 0);
+
+  CHECK(waitFor([&]() { return watcher.generation() > generation; }));
+  CHECK(watcher.snapshot()->getIntegerArg("-n") == 6);
+
+  generation = watcher.generation();
+
+  // new (empty) file is not loaded until closed after write
+  unlink(filename.c_str());
+
+  int fd = open(filename.c_str(), O_CREAT | O_WRONLY, 0644);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  CHECK(watcher.generation() == generation);
+  CHECK(watcher.snapshot()->getIntegerArg("-n") == 6);
+
+  CHECK(write(fd, "-n 7\n", 5) == 5);
+
+  close(fd);
+
+  CHECK(waitFor([&]() { return watcher.generation() > generation; }));
+  CHECK(watcher.snapshot()->getIntegerArg("-n") == 7);
+
+  watcher.stop();
+}
+
+//------
+
+static void
+testView()
+{
+  CArgs cargs("-v:f (verbose) -n:i=1 (number) -r:r=0.5 (real) -s:s=def (string) "
+              "-c:c[a,b=5,c] (choice) -D:Sm (define)");
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "42", "-s", "text",
+                                              "-c", "b", "-DX", "-DY", "pos" }));
+
+  CArgsView view(cargs);
+
+  CHECK(view.numOptions() == cargs.getNumArgs());
+  CHECK(view.lookup("-n") == 1);
+  CHECK(view.lookup("-none") == -1);
+
+  // concurrent readers see same values
+  std::atomic<int> failed { 0 };
+
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 10000; ++i) {
+        if (view.getBooleanArg("-v") || view.getIntegerArg("-n") != 42 ||
+            view.getRealArg("-r") != 0.5 || view.getStringArg("-s") != "text" ||
+            view.getChoiceArg("-c") != 5 || view.getStringListSize(5) != 2 ||
+            view.getStringListValue(5, 1) != "Y" || view.getPositional(0) != "pos")
+          ++failed;
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+    thread.join();
+
+  CHECK(failed == 0);
+
+  CHECK(view.isSet(1) && ! view.isSet(0));
+  CHECK(view.numPositionals() == 1);
+}
+
+// header fields (layout of CArgsView::Header)
+static uint32_t
+viewField(const std::vector<char> &data, size_t offset)
+{
+  uint32_t value;
+
+  memcpy(&value, &data[offset], sizeof(value));
+
+  return value;
+}
+
+static void
+testViewValidate()
+{
+  CArgs cargs("-v:f (verbose) -n:i=1 (number) -s:s (string) -D:Sm (define)");
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "2", "-DX", "pos" }));
+
+  CArgsView view(cargs);
+
+  std::vector<char> data(view.data(), view.data() + view.size());
+
+  std::string error;
+
+  CHECK(CArgsView::validate(&data[0], data.size(), error));
+
+  CArgsView view1(&data[0], data.size());
+
+  CHECK(view1.getIntegerArg("-n") == 2);
+  CHECK(view1.lookup("-none") == -1);
+
+  // truncated
+  CHECK(! CArgsView::validate(&data[0], data.size() - 1, error));
+  CHECK(! CArgsView::validate(&data[0], 8, error));
+
+  // hash table with no free slot (probe would not end)
+  {
+    auto data1 = data;
+
+    uint32_t hashSize   = viewField(data1, 20);
+    uint32_t hashOffset = viewField(data1, 72);
+
+    for (uint32_t i = 0; i < hashSize; ++i)
+      memset(&data1[hashOffset + i*sizeof(int32_t)], 0, sizeof(int32_t));
+
+    CHECK(! CArgsView::validate(&data1[0], data1.size(), error));
+
+    bool thrown = false;
+
+    try {
+      CArgsView view2(&data1[0], data1.size());
+    }
+    catch (...) {
+      thrown = true;
+    }
+
+    CHECK(thrown);
+  }
+
+  // any single byte change is rejected or gives a usable view
+  for (size_t i = 0; i < data.size(); ++i) {
+    for (int c : { 0x00, 0x01, 0x7f, 0xff }) {
+      auto data1 = data;
+
+      data1[i] = char(c);
+
+      if (! CArgsView::validate(&data1[0], data1.size(), error))
+        continue;
+
+      CArgsView view2(&data1[0], data1.size());
+
+      for (const char *name : { "-v", "-n", "-s", "-D", "-none" }) {
+        int id = view2.lookup(name);
+
+        CHECK(id >= -1 && id < view2.numOptions());
+      }
+
+      for (int id = 0; id < view2.numOptions(); ++id) {
+        try {
+          (void) view2.getName(id);
+          (void) view2.getValueText(id);
+
+          if (view2.getType(id) == CARG_TYPE_STRING) {
+            (void) view2.getString(id);
+
+            for (int j = 0; j < view2.getStringListSize(id); ++j)
+              (void) view2.getStringListValue(id, j);
+          }
+        }
+        catch (...) {
+        }
+      }
+
+      for (int j = 0; j < view2.numPositionals(); ++j)
+        (void) view2.getPositional(j);
+    }
+  }
+}
+
+//------
+
+static void
+testTokenizer()
+{
+  CArgsTokenizer tokenizer;
+
+  auto words = [&]() {
+    return std::vector<std::string>(tokenizer.argv(), tokenizer.argv() + tokenizer.argc());
+  };
+
+  CHECK(tokenizer.tokenize("a  'b c' \"d \\\"e\\\" \\x $\" f\\ g", "prog"));
+  CHECK(words() == (std::vector<std::string>{ "prog", "a", "b c", "d \"e\" \\x $", "f g" }));
+  CHECK(tokenizer.argv()[tokenizer.argc()] == nullptr);
+
+  // single quotes keep backslashes, adjacent quotes join
+  CHECK(tokenizer.tokenize("'a\\b'\"c\"d ''"));
+  CHECK(words() == (std::vector<std::string>{ "a\\bcd", "" }));
+
+  // comments and line continuation
+  CHECK(tokenizer.tokenize("a#b # comment\nc\\\nd \\#e"));
+  CHECK(words() == (std::vector<std::string>{ "a#b", "cd", "#e" }));
+
+  CHECK(tokenizer.tokenize("  \t\n "));
+  CHECK(tokenizer.argc() == 0);
+
+  CHECK(! tokenizer.tokenize("a 'b"));
+  CHECK(tokenizer.getError() != "");
+
+  CHECK(! tokenizer.tokenize("a \"b\\\""));
+
+  // parse command string
+  CArgs cargs("-n:i (number) -s:s (string)");
+
+  CHECK(cargs.parseString("-n 3 -s 'x y' p\\ q"));
+  CHECK(cargs.getIntegerArg("-n") == 3);
+  CHECK(cargs.getStringArg("-s") == "x y");
+  CHECK(cargs.getPositionals() == (std::vector<std::string>{ "p q" }));
+}
+
+//------
+
+static void
+testActions()
+{
+  static const char *opts = "-v:f (verbose) -n:im (number) -r:r (real) -s:Sm (string) "
+                            "-c:c[a,b=5] (choice) -z:b (size) -t:t (time) -q:q (rate) "
+                            "-e:c[h264,vp9] (enum) -o:f (other)";
+
+  auto run = [](bool argv) {
+    CArgs cargs(opts);
+
+    std::vector<std::string> log;
+
+    auto add = [&](const std::string &str) { log.push_back(str); };
+
+    cargs.setBooleanAction ("-v", [&](bool   value) { add("v" + std::to_string(value)); });
+    cargs.setIntegerAction ("-n", [&](long   value) { add("n" + std::to_string(value)); });
+    cargs.setRealAction    ("-r", [&](double value) { add("r" + std::to_string(value)); });
+    cargs.setStringAction  ("-s", [&](const std::string &value) { add("s" + value); });
+    cargs.setChoiceAction  ("-c", [&](long   value) { add("c" + std::to_string(value)); });
+    cargs.setSizeAction    ("-z", [&](long   value) { add("z" + std::to_string(value)); });
+    cargs.setDurationAction("-t", [&](long   value) { add("t" + std::to_string(value)); });
+    cargs.setRateAction    ("-q", [&](double value) { add("q" + std::to_string(value)); });
+
+    cargs.setEnumAction<Codec>("-e", [&](Codec value) { add("e" + std::to_string(int(value))); });
+
+    cargs.setAction("-o", [&](const CArg &arg) { add("o" + arg.getName()); });
+
+    std::vector<std::string> args { "prog", "-n", "1", "-sx", "-v", "-n", "2", "-c", "b",
+                                    "-z", "1k", "-sy", "-t", "2ms", "-q", "5/s", "-r", "0.5",
+                                    "-e", "vp9", "-o", "-n", "3" };
+
+    bool rc = (argv ? parseArgv(cargs, args) : cargs.parse(args));
+
+    return std::make_pair(rc, log);
+  };
+
+  std::vector<std::string> log { "n1", "sx", "v1", "n2", "c5", "z1000", "sy", "t2000000",
+                                 "q5.000000", "r0.500000", "e1", "o-o", "n3" };
+
+  CHECK(run(true ) == std::make_pair(true, log));
+  CHECK(run(false) == std::make_pair(true, log));
+
+  // not called for invalid value or unknown option
+  {
+    CArgs cargs(opts);
+
+    int count = 0;
+
+    cargs.setIntegerAction("-n", [&](long) { ++count; });
+
+    CHECK(! cargs.parse(std::vector<std::string>{ "prog", "-n", "x", "-n", "4", "-n", "" }));
+    CHECK(count == 1);
+  }
+
+  // type mismatch, unknown option
+  {
+    CArgs cargs(opts);
+
+    CHECK(throws([&]() { cargs.setIntegerAction("-r", [](long) { }); }));
+    CHECK(throws([&]() { cargs.setStringAction ("-n", [](const std::string &) { }); }));
+    CHECK(throws([&]() { cargs.setAction("-none", [](const CArg &) { }); }));
+  }
+}
+
+//------
+
+// two entries on one line (order is order in file)
+#define CARGS_TEST_DEFINE2 \
+  CARGS_DEFINE("-reg_b:f (b)"); CARGS_DEFINE("-reg_a:f (a)")
+
+CARGS_TEST_DEFINE2;
+CARGS_DEFINE("-reg_verbose:f (verbose)");
+
+static void
+testRegistry()
+{
+  // entries of this file then CArgsUnitTestDefs.cpp (sorted by file name)
+  std::vector<std::string> specs;
+
+  for (const auto *entry : CArgsRegistry::entries())
+    specs.push_back(entry->spec);
+
+  CHECK(specs == (std::vector<std::string>{ "-reg_b:f (b)", "-reg_a:f (a)",
+                                            "-reg_verbose:f (verbose)",
+                                            "-reg_jobs:i=4 (number of jobs)",
+                                            "-reg_log:s=out.log (log file)" }));
+
+  CArgs &cargs = CArgsRegistry::args();
+
+  CHECK(cargs.getNumArgs() == 5);
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-reg_a", "-reg_jobs", "8" }));
+  CHECK(cargs.getBooleanArg("-reg_a") && ! cargs.getBooleanArg("-reg_b"));
+  CHECK(cargs.getIntegerArg("-reg_jobs") == 8);
+  CHECK(cargs.getStringArg("-reg_log") == "out.log");
+}
+
+//------
+
+// parse matches same option as first option whose optionCmp matches
+static void
+testMatch()
+{
+  static const char *opts =
+    "-a:f (a) -ab:f (ab) -Abc:fn (abc) -abd:f (abd) -D:S (define) -Dx:f (dx) "
+    "-X:Sn (x) -XY:f (xy) -n:f (n) -N:f (upper n) -Long_Name:fn (long) -l:S (l)";
+
+  for (const char *opt : { "-a", "-ab", "-abc", "-ABC", "-aBc", "-abd", "-ABD", "-abcd",
+                           "-A", "-Dx", "-D1", "-D", "-d1", "-x1", "-X1", "-XY", "-xy",
+                           "-x", "-n", "-N", "-long_name", "-LONG_NAME", "-long_nam",
+                           "-l", "-lx", "-Lx", "-" }) {
+    CArgs cargs(opts);
+
+    int expected = -1;
+
+    for (int i = 0; i < cargs.getNumArgs(); ++i) {
+      if (cargs.getArg(i)->optionCmp(opt)) {
+        expected = i;
+        break;
+      }
+    }
+
+    (void) cargs.parse(std::vector<std::string>{ "prog", opt });
+
+    int matched = -1;
+
+    for (int i = 0; i < cargs.getNumArgs(); ++i)
+      if (cargs.getArg(i)->getSet())
+        matched = i;
+
+    if (matched != expected)
+      std::cerr << "option " << opt << " matched " << matched << " expected " << expected << "\n";
+
+    CHECK(matched == expected);
+  }
+}
+
+//------
+
+static void
+testStrings()
+{
+  // pool strings are not moved by later additions
+  {
+    CArgStringPool pool;
+
+    std::vector<std::string>      strs;
+    std::vector<std::string_view> views;
+
+    for (int i = 0; i < 2000; ++i) {
+      strs.push_back(std::string(size_t(i % 37 + 1), char('a' + i % 26)) + std::to_string(i));
+
+      if (i % 500 == 0)
+        strs.back() += std::string(2000, 'x');
+
+      views.push_back(pool.add(strs.back()));
+    }
+
+    CHECK(pool.add("").empty());
+
+    bool same = true;
+
+    for (size_t i = 0; i < strs.size(); ++i)
+      same = same && (views[i] == strs[i]);
+
+    CHECK(same);
+    CHECK(pool.memUsage() > 0);
+
+    pool.clear();
+
+    CHECK(pool.memUsage() == 0);
+  }
+
+  // escaped description and default are unescaped copies
+  {
+    CArgs cargs("-n:i=1 (number \\(count\\)) -s:s=a\\ b (string)");
+
+    CHECK(cargs.getArg(0)->getDesc() == "number (count)");
+    CHECK(cargs.getArg(0)->getNameView() == "-n");
+    CHECK(cargs.getStringArg("-s") == "a b");
+    CHECK(cargs.getArg(1)->getDescView() == "string");
+
+    // views stay valid when format is set again
+    cargs.setFormat("-m:i=2 (other \\(number\\))");
+
+    CHECK(cargs.getNumArgs() == 1);
+    CHECK(cargs.getArg(0)->getDesc() == "other (number)");
+    CHECK(cargs.getIntegerArg("-m") == 2);
+  }
+
+  // strings added by API are interned (caller's string can change)
+  {
+    CArgs cargs("-v:f (verbose)");
+
+    std::string name = "-codec";
+    std::string desc = "video codec";
+
+    cargs.addEnumArg(name, CARG_FLAG_NONE, Codec::av1, false, desc);
+
+    name.assign(100, 'x');
+    desc.assign(100, 'y');
+
+    CHECK(cargs.getArg(1)->getName() == "-codec");
+    CHECK(cargs.getArg(1)->getDesc() == "video codec");
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-codec", "vp9", "-v" }));
+    CHECK(cargs.getArg<Codec>("-codec") == Codec::vp9);
+  }
+}
+
+//------
+
+static void
+testViewString()
+{
+  CArgs cargs("-v:f (verbose) -n:i=1 (number) -s:s (string) -D:Sm (define)");
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "2", "-s", "a b", "-DX", "pos" }));
+
+  CArgsView view(cargs);
+
+  std::string str = view.toString();
+
+  // round trip
+  auto view1 = CArgsView::fromString(str);
+
+  CHECK(view1 && view1->size() == view.size() &&
+        memcmp(view1->data(), view.data(), view.size()) == 0);
+  CHECK(view1 && view1->getIntegerArg("-n") == 2 && view1->getStringArg("-s") == "a b" &&
+        view1->getPositional(0) == "pos");
+
+  // truncated
+  CHECK(! CArgsView::fromString(""));
+  CHECK(! CArgsView::fromString(str.substr(0, str.size() - 1)));
+  CHECK(! CArgsView::fromString(str.substr(0, str.size() - 4)));
+  CHECK(! CArgsView::fromString(str.substr(0, 16)));
+
+  // bad alphabet
+  for (char c : { '!', '-', '_', ' ', '\n', '\0', '\xc3' }) {
+    auto str1 = str;
+
+    str1[str1.size()/2] = c;
+
+    CHECK(! CArgsView::fromString(str1));
+  }
+
+  // valid base64 of invalid data
+  {
+    auto str1 = str;
+
+    str1[0] = (str1[0] == 'A' ? 'B' : 'A');
+
+    CHECK(! CArgsView::fromString(str1));
+  }
+}
+
+//------
+
+static void
+testShared()
+{
+  CArgs cargs("-n:i=1 (number) -r:r (real) -s:s (string) -c:c[a,b=5] (choice) "
+              "-z:b (size) -t:t (time) -D:Sm (define)");
+
+  CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "3", "-r", "1.5", "-s", "text",
+                                              "-c", "b", "-z", "4Ki", "-t", "2s",
+                                              "-DX", "-DY", "pos" }));
+
+  CArgsView view(cargs);
+
+  auto checkView = [](const CArgsView *view1) {
+    return (view1 && view1->getIntegerArg("-n") == 3 && view1->getRealArg("-r") == 1.5 &&
+            view1->getStringArg("-s") == "text" && view1->getChoiceArg("-c") == 5 &&
+            view1->getSizeArg("-z") == 4096 && view1->getDurationArg("-t") == 2000000000L &&
+            view1->getStringListSize(6) == 2 && view1->getStringListValue(6, 1) == "Y" &&
+            view1->getPositional(0) == "pos");
+  };
+
+  // sealed memfd
+  {
+    int fd = view.createShared("cargs");
+
+    CHECK(fd >= 0);
+
+    int seals = fcntl(fd, F_GET_SEALS);
+
+    CHECK(seals >= 0 && (seals & F_SEAL_WRITE) && (seals & F_SEAL_SHRINK));
+    CHECK(pwrite(fd, "x", 1, 0) < 0);
+
+    auto view1 = CArgsView::mapShared(fd);
+
+    close(fd);
+
+    CHECK(checkView(view1.get()));
+  }
+
+  // named shared memory object (read only descriptor, data copied)
+  {
+    std::string name = "/cargs_test_" + std::to_string(getpid());
+
+    int fd = view.createShared(name);
+
+    CHECK(fd >= 0);
+    CHECK((fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDONLY);
+
+    // exists
+    CHECK(view.createShared(name) < 0);
+
+    auto view1 = CArgsView::mapShared(fd);
+    auto view2 = CArgsView::openShared(name);
+
+    close(fd);
+
+    CHECK(checkView(view1.get()));
+    CHECK(checkView(view2.get()));
+
+    // changed (and invalid) data does not change mapped views
+    int fd1 = shm_open(name.c_str(), O_RDWR, 0);
+
+    CHECK(fd1 >= 0);
+
+    std::vector<char> zeros(view.size());
+
+    CHECK(pwrite(fd1, &zeros[0], zeros.size(), 0) == ssize_t(zeros.size()));
+
+    close(fd1);
+
+    CHECK(checkView(view1.get()));
+    CHECK(checkView(view2.get()));
+
+    CHECK(! CArgsView::openShared(name));
+
+    shm_unlink(name.c_str());
+
+    CHECK(! CArgsView::openShared(name));
+  }
+
+  // invalid descriptor
+  CHECK(! CArgsView::mapShared(-1));
+}
+
+//------
+
+static CArgFingerprint
+parseFingerprint(const char *opts, const std::vector<std::string> &args)
+{
+  CArgs cargs(opts);
+
+  CHECK(cargs.parse(args));
+
+  return cargs.getFingerprint();
+}
+
+static void
+testFingerprint()
+{
+  static const char *opts = "-i:I (attached) -n:i (number) -r:r (real) -q:q (rate) "
+                            "-s:s (string) -v:f (verbose)";
+
+  auto fp = [](const std::vector<std::string> &args) { return parseFingerprint(opts, args); };
+
+  auto fp0 = fp({ "prog" });
+
+  // spelling of values
+  CHECK(fp({ "prog", "-i5" }) == fp({ "prog", "-i05" }));
+  CHECK(fp({ "prog", "-n", "5" }) == fp({ "prog", "-n", "05" }));
+  CHECK(fp({ "prog", "-n", "5" }) != fp({ "prog", "-n", "6" }));
+  CHECK(fp({ "prog", "-i5" }) != fp({ "prog", "-n", "5" }));
+
+  // order of arguments
+  CHECK(fp({ "prog", "-n", "1", "-s", "x", "-v" }) == fp({ "prog", "-v", "-s", "x", "-n", "1" }));
+
+  // equal real values
+  CHECK(fp({ "prog", "-r", "-0" }) == fp({ "prog", "-r", "0" }));
+  CHECK(fp({ "prog", "-r", "1.50" }) == fp({ "prog", "-r", "1.5" }));
+  CHECK(fp({ "prog", "-r", "nan" }) == fp({ "prog", "-r", "-nan" }));
+  CHECK(fp({ "prog", "-r", "nan" }) != fp({ "prog", "-r", "0" }));
+
+  // equal rates
+  CHECK(fp({ "prog", "-q", "10k/s" }) == fp({ "prog", "-q", "600k/min" }));
+  CHECK(fp({ "prog", "-q", "0.5/s" }) == fp({ "prog", "-q", "30/min" }));
+  CHECK(fp({ "prog", "-q", "10k/s" }) != fp({ "prog", "-q", "10k/min" }));
+
+  // set flag (value is default)
+  CHECK(fp({ "prog", "-n", "0" }) != fp0);
+  CHECK(fp({ "prog", "-s", "" }) != fp0);
+
+  // strings are length prefixed
+  CHECK(fp({ "prog", "-s", "ab" }) != fp({ "prog", "-s", "a" }));
+
+  // incremental fingerprint equals fingerprint of all options
+  {
+    CArgs cargs(opts);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "1", "-n", "2", "-r", "3" }));
+
+    CArgFingerprint sum;
+
+    for (int id = 0; id < cargs.getNumArgs(); ++id) {
+      sum.lo += cargs.getArgFingerprint(id).lo;
+      sum.hi += cargs.getArgFingerprint(id).hi;
+    }
+
+    CHECK(cargs.getFingerprint() == sum);
+    CHECK(cargs.getFingerprint() == fp({ "prog", "-r", "3", "-n", "2" }));
+
+    // reset of set flags (values kept)
+    auto fp1 = cargs.getFingerprint();
+
+    cargs.resetSet();
+
+    CHECK(cargs.getFingerprint() != fp1);
+    CHECK(cargs.getFingerprint() != fp0);
+
+    sum = CArgFingerprint();
+
+    for (int id = 0; id < cargs.getNumArgs(); ++id) {
+      sum.lo += cargs.getArgFingerprint(id).lo;
+      sum.hi += cargs.getArgFingerprint(id).hi;
+    }
+
+    CHECK(cargs.getFingerprint() == sum);
+  }
+
+  // reset of default values is same as not set
+  {
+    CArgs cargs(opts);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-n", "0", "-s", "" }));
+    CHECK(cargs.getFingerprint() != fp0);
+
+    cargs.resetSet();
+
+    CHECK(cargs.getFingerprint() == fp0);
+  }
+
+  CHECK(fp0.toString().size() == 32);
+}
+
+//------
+
+static void
+testDiff()
+{
+  // two blocks of options
+  static const char *opts = "-a:i (a) -b:i (b) -c:i (c) -d:i (d) -e:i (e) -f:i (f) -g:i (g) "
+                            "-h:i (h) -j:i=1 (j) -k:i (k) -s:s (string)";
+
+  auto build = [](const std::vector<std::string> &args) {
+    CArgs cargs(opts);
+
+    CHECK(cargs.parse(args));
+
+    return std::make_unique<CArgsView>(cargs);
+  };
+
+  CArgsView::Changes changes;
+
+  // equal views
+  {
+    auto v1 = build({ "prog", "-a", "1", "-k", "2" });
+    auto v2 = build({ "prog", "-k", "2", "-a", "01" });
+
+    CHECK(v1->fingerprint() == v2->fingerprint());
+    CHECK(CArgsView::diff(*v1, *v2, changes) && changes.empty());
+  }
+
+  // change in second block
+  {
+    auto v1 = build({ "prog", "-a", "1", "-k", "2" });
+    auto v2 = build({ "prog", "-a", "1", "-k", "3" });
+
+    CHECK(CArgsView::diff(*v1, *v2, changes) && changes.size() == 1);
+
+    if (changes.size() == 1) {
+      CHECK(changes[0].id == 9);
+      CHECK(changes[0].oldValue == "2" && changes[0].newValue == "3");
+      CHECK(changes[0].oldSet && changes[0].newSet);
+    }
+  }
+
+  // changes in both blocks (in id order)
+  {
+    auto v1 = build({ "prog", "-h", "1", "-s", "x" });
+    auto v2 = build({ "prog", "-s", "y", "-b", "2" });
+
+    CHECK(CArgsView::diff(*v1, *v2, changes) && changes.size() == 3);
+
+    if (changes.size() == 3)
+      CHECK(changes[0].id == 1 && changes[1].id == 7 && changes[2].id == 10);
+  }
+
+  // set with same (default) value
+  {
+    auto v1 = build({ "prog" });
+    auto v2 = build({ "prog", "-j", "1" });
+
+    CHECK(CArgsView::diff(*v1, *v2, changes) && changes.size() == 1);
+
+    if (changes.size() == 1) {
+      CHECK(changes[0].id == 8);
+      CHECK(! changes[0].oldSet && changes[0].newSet);
+      CHECK(changes[0].oldValue == changes[0].newValue);
+    }
+  }
+
+  // value changed outside parse
+  {
+    CArgs cargs(opts);
+
+    CHECK(cargs.parse(std::vector<std::string>{ "prog", "-a", "2" }));
+
+    CArgsView v1(cargs);
+
+    CHECK(cargs.getArg(0)->setValue("-a", std::vector<std::string>{ "7" }));
+
+    CArgsView v2(cargs);
+
+    CHECK(v1.fingerprint() != v2.fingerprint());
+    CHECK(CArgsView::diff(v1, v2, changes) && changes.size() == 1);
+
+    if (changes.size() == 1)
+      CHECK(changes[0].id == 0 && changes[0].oldValue == "2" && changes[0].newValue == "7");
+  }
+
+  // different spec
+  {
+    auto v1 = build({ "prog" });
+
+    CArgs cargs("-a:i (a)");
+
+    CArgsView v2(cargs);
+
+    CHECK(throws([&]() { CArgsView::diff(*v1, v2, changes); }));
+  }
+}
+
+static void
+testCache()
+{
+  CArgsCache cache("-v:f (verbose) -n:i=1 (number)", 4, 1);
+
+  CHECK(cache.isCacheable());
+
+  auto view1 = cache.parse(std::vector<std::string>{ "prog", "-n", "3" });
+  auto view2 = cache.parse(std::vector<std::string>{ "other", "-n", "3" });
+
+  CHECK(view1 && view1 == view2 && view1->getIntegerArg("-n") == 3);
+  CHECK(cache.hits() == 1 && cache.misses() == 1);
+
+  auto view3 = cache.parse(std::vector<std::string>{ "prog", "-n", "4" });
+
+  CHECK(view3 && view3 != view1 && view3->getIntegerArg("-n") == 4);
+  CHECK(cache.misses() == 2 && cache.size() == 2);
+
+  // failed parse not cached
+  CHECK(! cache.parse(std::vector<std::string>{ "prog", "-n", "x" }));
+  CHECK(! cache.parse(std::vector<std::string>{ "prog", "-n", "x" }));
+  CHECK(cache.size() == 2 && cache.hits() == 1);
+
+  // path checks depend on file system so are never cached
+  std::string filename = tempDir() + "/cache_in";
+
+  CArgsCache pathCache("-in:p[exists] (input)");
+
+  CHECK(! pathCache.isCacheable());
+  CHECK(! pathCache.parse(std::vector<std::string>{ "prog", "-in", filename }));
+
+  writeFile(filename, "");
+
+  CHECK(pathCache.parse(std::vector<std::string>{ "prog", "-in", filename }));
+  CHECK(pathCache.parse(std::vector<std::string>{ "prog", "-in", filename }));
+  CHECK(pathCache.hits() == 0 && pathCache.size() == 0);
+
+  // response file contents are re-read
+  std::string respname = tempDir() + "/cache_resp";
+
+  CArgsCache respCache("-n:i=1 (number)");
+
+  CHECK(respCache.isCacheable());
+
+  respCache.setInitProc([](CArgs &cargs) { cargs.setResponseFiles(true); });
+
+  CHECK(! respCache.isCacheable());
+
+  writeFile(respname, "-n 5\n");
+
+  auto view4 = respCache.parse(std::vector<std::string>{ "prog", "@" + respname });
+
+  writeFile(respname, "-n 6\n");
+
+  auto view5 = respCache.parse(std::vector<std::string>{ "prog", "@" + respname });
+
+  CHECK(view4 && view4->getIntegerArg("-n") == 5);
+  CHECK(view5 && view5->getIntegerArg("-n") == 6);
+  CHECK(respCache.hits() == 0);
+}
+
+static void
+testLayers()
+{
+  CArgsLayers layers("-j:i=1 (jobs) -l:s=out.log (log) -v:f (verbose) "
+                     "-o:sr (output) -t:i=10 (timeout)");
+
+  int j = layers.getArgIndex("-j"), l = layers.getArgIndex("-l"),
+      v = layers.getArgIndex("-v"), o = layers.getArgIndex("-o"),
+      t = layers.getArgIndex("-t");
+
+  CHECK(layers.getInteger(j) == 1 && layers.getLayer(j) == CArgsLayers::LAYER_DEFAULTS);
+
+  // required option only set by config (not an error for env or argv)
+  std::string config = tempDir() + "/layers_config";
+
+  writeFile(config, "-j 2 -l config.log -o config.out\n");
+
+  CHECK(layers.parseConfig(config));
+
+  setenv("LAYERS_J", "3", 1);
+  setenv("LAYERS_V", "1", 1);
+
+  CHECK(layers.parseEnv("LAYERS_"));
+
+  unsetenv("LAYERS_J");
+  unsetenv("LAYERS_V");
+
+  std::string resp = tempDir() + "/layers_resp";
+
+  writeFile(resp, "-t 20\n");
+
+  std::vector<std::string> args { "prog", "-j", "4", "@" + resp, "in1", "in2" };
+
+  std::vector<char *> argv;
+
+  for (auto &arg : args)
+    argv.push_back(&arg[0]);
+
+  argv.push_back(nullptr);
+
+  CHECK(layers.parseArgv(int(args.size()), &argv[0], /*responseFiles*/true));
+  CHECK(layers.checkRequired());
+
+  CHECK(layers.getInteger(j) == 4 && layers.getLayer(j) == CArgsLayers::LAYER_ARGV);
+  CHECK(layers.getString(l) == "config.log" && layers.getLayer(l) == CArgsLayers::LAYER_CONFIG);
+  CHECK(layers.getBoolean(v) && layers.getLayer(v) == CArgsLayers::LAYER_ENV);
+  CHECK(layers.getString(o) == "config.out");
+  CHECK(layers.getInteger(t) == 20);
+  CHECK(layers.getPositionals() == (std::vector<std::string>{ "in1", "in2" }));
+
+  // lower layer values shown when top layer cleared
+  layers.clearLayer(CArgsLayers::LAYER_ARGV);
+
+  CHECK(layers.getInteger(j) == 3 && layers.getInteger(t) == 10);
+  CHECK(layers.getPositionals().empty());
+
+  // required option not set by any layer
+  layers.clearLayer(CArgsLayers::LAYER_CONFIG);
+
+  CHECK(layers.getString(l) == "out.log");
+  CHECK(! layers.checkRequired());
+}
+
+static void
+testFixed()
+{
+  typedef CArgsFixed<4, 2, 32> Fixed;
+
+  Fixed fixed("-j:i{1,}=1 (jobs) -r:r{,0.5} (ratio) -Verbose:fn (verbose) "
+              "-Mode:c[fast,slow=5]n (mode)");
+
+  CHECK(fixed.getError() == Fixed::ERROR_NONE && fixed.getNumArgs() == 4);
+
+  const char *argv1[] = { "prog", "-j", "1000000", "-r", "-3", "-verbose", "-MODE", "SLOW" };
+
+  CHECK(fixed.parse(8, argv1));
+  CHECK(fixed.getInteger(0) == 1000000 && fixed.getReal(1) == -3.0);
+  CHECK(fixed.getBoolean(2) && fixed.getChoice(3) == 5);
+
+  const char *argv2[] = { "prog", "-j", "0" };
+
+  CHECK(! fixed.parse(3, argv2) && fixed.getError() == Fixed::ERROR_INVALID_VALUE);
+  CHECK(fixed.getErrorOption() == 0);
+
+  const char *argv3[] = { "prog", "-r", "0.6" };
+
+  CHECK(! fixed.parse(3, argv3) && fixed.getError() == Fixed::ERROR_INVALID_VALUE);
+
+  // capacity overflows
+  const char *argv4[] = { "prog", "a", "b", "c" };
+
+  CHECK(! fixed.parse(4, argv4) && fixed.getError() == Fixed::ERROR_TOO_MANY_POSITIONALS);
+  CHECK(fixed.getErrorIndex() == 3);
+
+  const char *argv5[] = { "prog", "0123456789abcdef", "0123456789abcdef" };
+
+  CHECK(! fixed.parse(3, argv5) && fixed.getError() == Fixed::ERROR_TOO_MANY_BYTES);
+
+  // values reset by next parse
+  const char *argv6[] = { "prog" };
+
+  CHECK(fixed.parse(1, argv6) && fixed.getInteger(0) == 1 && ! fixed.isSet(2));
+
+  Fixed fixed2("-a:f -b:f -c:f -d:f -e:f");
+
+  CHECK(fixed2.getError() == Fixed::ERROR_TOO_MANY_OPTIONS && fixed2.getNumArgs() == 4);
+
+  Fixed fixed3("-s:s=0123456789012345678901234567890123456789");
+
+  CHECK(fixed3.getError() == Fixed::ERROR_TOO_MANY_BYTES);
+
+  Fixed fixed4("-j:i{1} (jobs)");
+
+  CHECK(fixed4.getError() == Fixed::ERROR_FORMAT);
+}
+
+#define STRUCT_OPTIONS(X) \
+  X(verbose, Boolean , ""          , "verbose output" ) \
+  X(jobs   , Integer , "{1,64}=4"  , "number of jobs" ) \
+  X(scale  , Real    , "=1.5"      , "scale factor"   ) \
+  X(codec  , Choice  , "[h264,vp9]", "output codec"   ) \
+  X(log    , String  , "=out.log"  , "log file"       ) \
+  X(timeout, Duration, "=250ms"    , "request timeout")
+
+CARGS_STRUCT(StructOptions, STRUCT_OPTIONS)
+
+static void
+testStruct()
+{
+  CHECK(std::string(StructOptions::cargsSpec()) ==
+        "-verbose:f (verbose output) -jobs:i{1,64}=4 (number of jobs) "
+        "-scale:r=1.5 (scale factor) -codec:c[h264,vp9] (output codec) "
+        "-log:s=out.log (log file) -timeout:t=250ms (request timeout) ");
+
+  // defaults
+  {
+    StructOptions opts;
+    CArgs         cargs;
+
+    opts.cargsBind(cargs);
+
+    CHECK(! opts.verbose && opts.jobs == 4 && opts.scale == 1.5);
+    CHECK(opts.log == "out.log" && opts.timeout == 250000000L);
+  }
+
+  // parsed values
+  {
+    StructOptions opts;
+    CArgs         cargs;
+
+    std::vector<std::string> args { "prog", "-verbose", "-jobs", "8", "-codec", "vp9",
+                                    "-log", "run.log", "-timeout", "2s" };
+
+    std::vector<char *> argv;
+
+    for (auto &arg : args)
+      argv.push_back(&arg[0]);
+
+    argv.push_back(nullptr);
+
+    CHECK(opts.cargsParse(cargs, int(args.size()), &argv[0]));
+
+    CHECK(opts.verbose && opts.jobs == 8 && opts.scale == 1.5 && opts.codec == 1);
+    CHECK(opts.log == "run.log" && opts.timeout == 2000000000L);
+  }
+}
+
+// parse with CArgs and generated parser (CArgsUnitTestGen.def) and compare
+// result, messages and values
+static bool
+compareGen(const std::vector<std::string> &args)
+{
+  std::vector<std::string> args1 { "prog" };
+
+  args1.insert(args1.end(), args.begin(), args.end());
+
+  std::vector<char *> argv;
+
+  for (auto &arg : args1)
+    argv.push_back(&arg[0]);
+
+  argv.push_back(nullptr);
+
+  int argc = int(args1.size());
+
+  CArgs        cargs(CArgsGenTest::format());
+  CArgsGenTest gen;
+
+  std::stringstream os1, os2;
+
+  auto *buf = std::cerr.rdbuf(os1.rdbuf());
+
+  os1 << cargs.parse(argc, &argv[0]) << "|";
+
+  std::cerr.rdbuf(os2.rdbuf());
+
+  os2 << gen.parse(argc, &argv[0]) << "|";
+
+  std::cerr.rdbuf(buf);
+
+  for (int id = 0; id < cargs.getNumArgs(); ++id)
+    os1 << cargs.getArg(id)->getSet();
+
+  for (int id = 0; id < CArgsGenTest::NUM_ARGS; ++id)
+    os2 << gen.isSet(id);
+
+  os1 << "|" << cargs.getBooleanArg("-v") << cargs.getBooleanArg("-q") <<
+         cargs.getBooleanArg("-V") << "," << cargs.getIntegerArg("-n") << "," <<
+         cargs.getRealArg("-scale") << "," << cargs.getStringArg("-o") << "," <<
+         cargs.getChoiceArg("-c") << "," << cargs.getStringArg("-D") << "," <<
+         cargs.getIntegerArg("-L") << "," << cargs.getStringArg("-name") << "," <<
+         cargs.getBooleanArg("-Ab") << cargs.getBooleanArg("-ab") << "," <<
+         cargs.getIntegerArg("-class") << "," << cargs.getBooleanArg("-not") <<
+         cargs.getBooleanArg("-or") << cargs.getBooleanArg("-mutable") << "," <<
+         cargs.getIntegerArg("-a__b") << "|";
+
+  os2 << "|" << gen.v << gen.q << gen.V << "," << gen.n << "," << gen.scale << "," <<
+         gen.o << "," << gen.cArg << "," << gen.D << "," << gen.L << "," << gen.name << "," <<
+         gen.Ab << gen.ab << "," << gen.classArg << "," << gen.notArg << gen.orArg <<
+         gen.mutableArg << "," << gen.a_b << "|";
+
+  for (const auto &positional : cargs.getPositionals())
+    os1 << positional << " ";
+
+  for (const auto &positional : gen.positionals_)
+    os2 << positional << " ";
+
+  os1 << "|" << cargs.isHelp();
+  os2 << "|" << gen.help_;
+
+  if (os1.str() == os2.str())
+    return true;
+
+  std::cerr << "CArgs:\n" << os1.str() << "\nGenerated:\n" << os2.str() << "\n";
+
+  return false;
+}
+
+static void
+testGen()
+{
+  std::vector<std::vector<std::string>> cases = {
+    { "-o", "x" }, { }, { "-o", "x", "-n", "7" }, { "-o", "x", "-n", "11" },
+    { "-o", "x", "-n", "abc" }, { "-n" }, { "-o", "x", "-vq" }, { "-o", "x", "-vz" },
+    { "-o", "x", "-V" }, { "-o", "x", "-v" }, { "-O", "x" }, { "-o", "x", "-c", "HIGH" },
+    { "-o", "x", "-c", "bad" }, { "-o", "x", "-Dfoo=1", "-DX" }, { "-o", "x", "-L7" },
+    { "-o", "x", "-L7x", "end" }, { "-Lx", "-o", "x" }, { "-o", "x", "--", "-v", "p" },
+    { "p1", "-o", "x", "p2" }, { "-o", "x", "-scale", "2.5" }, { "-o", "x", "-scale", "0.25" },
+    { "-o", "x", "-scale", "x" }, { "-o", "x", "-Ab", "-ab", "-AB" },
+    { "-o", "x", "-class", "-3" }, { "-o", "x", "-name" }, { "-o", "x", "-name", "q" },
+    { "-" }, { "-o", "x", "--help" }, { "-o", "x", "-x" }, { "-o", "x", "-vV" },
+    { "-o", "x", "-n", "05" }, { "-o", "x", "-n", "" }, { "-o" }, { "-o", "x", "-o", "y" },
+    { "-o", "x", "-not", "-or", "-mutable", "-a__b", "9" }
+  };
+
+  for (const auto &args : cases)
+    CHECK(compareGen(args));
+}
+
+//------
+
+int
+main()
+{
+  testChoice();
+  testEnum();
+  testValidate();
+  testUnits();
+  testCustom();
+  testPaths();
+  testGlob();
+  testArgvBuilder();
+  testWatcher();
+  testView();
+  testViewValidate();
+  testTokenizer();
+  testActions();
+  testRegistry();
+  testMatch();
+  testStrings();
+  testViewString();
+  testShared();
+  testFingerprint();
+  testDiff();
+  testCache();
+  testLayers();
+  testFixed();
+  testStruct();
+  testGen();
+
+  if (num_failed)
+    std::cerr << num_failed << " checks failed\n";
+  else
+    std::cout << "all checks passed\n";
+
+  return num_failed;
+}
@@ -0,0 +1,5 @@
+#include <CArgsRegistry.h>
+
+// options defined in a second translation unit (for CArgsRegistry checks)
+CARGS_DEFINE("-reg_jobs:i=4 (number of jobs)");
+CARGS_DEFINE("-reg_log:s=out.log (log file)");